@@ -1,17 +1,27 @@
-#include "console_widget.h"
+﻿#include "console_widget.h"
+
+#include <algorithm>
+#include <utility>
 
 #include <QFile>
 #include <QFileDialog>
 #include <QTextStream>
 #include <QDateTime>
-#include <QTextCharFormat>
 #include <QAbstractItemView>
 #include <QStandardItem>
 #include <QTranslator>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QShortcut>
+#include <QStandardPaths>
+#include <QDir>
+#include <QApplication>
+#include <QMouseEvent>
 
 #include "objects/con_var/con_var.h"
+#include "objects/line_viewer/line_viewer.h"
 
-ConsoleWidget::ConsoleWidget( QWidget* parent ) : QWidget( parent ), ui( new Ui::ConsoleWidgetClass() ), completer( new ConsoleCompleter( this ) ), completerModel( new QStandardItemModel( this ) )
+ConsoleWidget::ConsoleWidget( QWidget* parent ) : QWidget( parent ), ui( new Ui::ConsoleWidgetClass() ), core( new ConsoleCore( this ) ), completer( new ConsoleCompleter( this ) ), completerModel( new QStandardItemModel( this ) ), lineFilter( new LineFilter( this ) ), lineFinder( new LineFinder( this ) )
 {
 	ui->setupUi( this );
 
@@ -26,11 +36,61 @@ ConsoleWidget::ConsoleWidget( QWidget* parent ) : QWidget( parent ), ui( new Ui:
 
 	consoles.push_back( this );
 
+	// Only the first console keeps the history by default, consoles sharing a file would rewrite it over each other
+	if ( consoles.size() == 1 )
+		core->SetHistoryFile( GetDefaultHistoryFile() );
+
 	connect( ui->commandLineEdit, &QLineEdit::returnPressed, this, &ConsoleWidget::OnCommandEntered );
+	connect( ui->commandLineEdit, &QLineEdit::textEdited, this, &ConsoleWidget::CommandTextEdited );
 	connect( ui->submitButton, &QPushButton::clicked, this, &ConsoleWidget::OnCommandEntered );
 	connect( ui->exportLogButton, &QPushButton::clicked, this, &ConsoleWidget::SaveLogs );
 	connect( completer, &ConsoleCompleter::TabPressed, this, &ConsoleWidget::TabPressed );
 	connect( ui->filterLineEdit, &QLineEdit::textChanged, this, &ConsoleWidget::FilterChanged );
+	connect( lineFilter, &LineFilter::Finished, this, &ConsoleWidget::FilterFinished );
+	connect( lineFinder, &LineFinder::Finished, this, &ConsoleWidget::FindFinished );
+
+	connect( core, &ConsoleCore::LineAdded, this, &ConsoleWidget::OnLineAdded );
+	connect( core, &ConsoleCore::FirstLineRemoved, this, &ConsoleWidget::OnFirstLineRemoved );
+	connect( core, &ConsoleCore::Cleared, this, &ConsoleWidget::OnCleared );
+	connect( core, &ConsoleCore::BatchStarted, this, &ConsoleWidget::OnBatchStarted );
+	connect( core, &ConsoleCore::BatchFinished, this, &ConsoleWidget::OnBatchFinished );
+	connect( core, &ConsoleCore::CommandsChanged, this, &ConsoleWidget::UpdateCommands );
+	connect( core, &ConsoleCore::SearchRequested, this, &ConsoleWidget::ShowSearch );
+	connect( ui->consoleTextEdit->verticalScrollBar(), &QScrollBar::valueChanged, this, &ConsoleWidget::OnScrolled );
+
+	ui->findBarWidget->hide();
+	ui->historySearchLabel->hide();
+
+	auto* historySearchShortcut = new QShortcut( QKeySequence( Qt::CTRL | Qt::Key_R ), ui->commandLineEdit );
+	historySearchShortcut->setContext( Qt::WidgetShortcut );
+
+	connect( historySearchShortcut, &QShortcut::activated, this, &ConsoleWidget::SearchHistory );
+
+	auto* findShortcut = new QShortcut( QKeySequence::Find, this );
+	findShortcut->setContext( Qt::WidgetWithChildrenShortcut );
+
+	auto* closeFindShortcut = new QShortcut( QKeySequence( Qt::Key_Escape ), ui->findBarWidget );
+	closeFindShortcut->setContext( Qt::WidgetWithChildrenShortcut );
+
+	connect( findShortcut, &QShortcut::activated, this, &ConsoleWidget::ShowFindBar );
+	connect( closeFindShortcut, &QShortcut::activated, this, &ConsoleWidget::HideFindBar );
+	connect( ui->findCloseButton, &QPushButton::clicked, this, &ConsoleWidget::HideFindBar );
+	connect( ui->findLineEdit, &QLineEdit::textChanged, this, &ConsoleWidget::FindTextChanged );
+	connect( ui->findNextButton, &QPushButton::clicked, this, &ConsoleWidget::FindNext );
+	connect( ui->findPreviousButton, &QPushButton::clicked, this, &ConsoleWidget::FindPrevious );
+	connect( ui->findLineEdit, &QLineEdit::returnPressed, this, [ this ]
+	{
+		if ( QApplication::keyboardModifiers() & Qt::ShiftModifier )
+			FindPrevious();
+		else
+			FindNext();
+	} );
+
+	// Lines are styled while laid out, the document never stores their colors
+	highlighter = new ConsoleHighlighter( ui->consoleTextEdit, [ this ]( const int blockNumber ) { return GetLineColor( blockNumber ); } );
+
+	ui->consoleTextEdit->viewport()->installEventFilter( this );
+	connect( ui->findFullLinesCheckBox, &QCheckBox::toggled, this, [ this ] { FindTextChanged( ui->findLineEdit->text() ); } );
 
 	ui->commandLineEdit->setCompleter( completer );
 	completer->setModel( completerModel );
@@ -38,54 +98,20 @@ ConsoleWidget::ConsoleWidget( QWidget* parent ) : QWidget( parent ), ui( new Ui:
 	UpdateCommands();
 }
 
-void ConsoleWidget::AddLine( const QString& line, const ePrintType type )
+QString ConsoleWidget::GetDefaultHistoryFile()
 {
-	QTextCharFormat format;
-	format.setForeground( printColors[ type ] );
-	ui->consoleTextEdit->moveCursor( QTextCursor::End );
-	ui->consoleTextEdit->setCurrentCharFormat( format );
-
-	QString str;
-	QString timestamp = QDateTime::currentDateTime().toString( "[yyyy-MM-dd hh:mm:ss]" );
-
-	switch ( type )
-	{
-	case ePrintType::PRINT_INFO:
-		str = QString( "%1 [INFO]     %2" ).arg( timestamp, line );
-		break;
-	case ePrintType::PRINT_NOTICE:
-		str = QString( "%1 [NOTICE]   %2" ).arg( timestamp, line );
-		break;
-	case ePrintType::PRINT_WARNING:
-		str = QString( "%1 [WARNING]  %2" ).arg( timestamp, line );
-		break;
-	case ePrintType::PRINT_ERROR:
-		str = QString( "%1 [ERROR]    %2" ).arg( timestamp, line );
-		break;
-	case ePrintType::PRINT_SUCCESS:
-		str = QString( "%1 [SUCCESS]  %2" ).arg( timestamp, line );
-		break;
-	}
-
-	ui->consoleTextEdit->appendPlainText( str );
+	const QString directory = QStandardPaths::writableLocation( QStandardPaths::AppDataLocation );
 
-	LineData data;
-	data.Text = str;
-	data.Type = type;
-	data.Color = printColors[ type ];
-	lines.push_back( data );
+	if ( directory.isEmpty() || !QDir().mkpath( directory ) )
+		return {};
 
-	if ( lines.size() > MaxLineCount )
-	{
-		RemoveFirstLine();
-		lines.pop_front();
-	}
+	return directory + "/console_history.txt";
 }
 
-void ConsoleWidget::Clear()
+ConsoleWidget::~ConsoleWidget()
 {
-	ui->consoleTextEdit->clear();
-	lines.clear();
+	consoles.removeOne( this );
+	delete ui;
 }
 
 void ConsoleWidget::SetupFonts( const QFont& consoleFont, const QFont& commandFont, const QFont& completerFont ) const
@@ -158,80 +184,180 @@ void ConsoleWidget::SetupConsolesFonts( const QFont& font, const QFont& commandF
 	}
 }
 
-void ConsoleWidget::UpdateConsolesCommands()
+void ConsoleWidget::keyPressEvent( QKeyEvent* event )
 {
-	for ( const ConsoleWidget* console : consoles )
+	const int key = event->key();
+
+	// Leaving the search keeps the found command in the line
+	if ( historySearching && ( key == Qt::Key_Escape || key == Qt::Key_Up || key == Qt::Key_Down ) )
 	{
-		if ( console )
-			console->UpdateCommands();
+		StopHistorySearch( true );
+
+		if ( key == Qt::Key_Escape )
+			return;
 	}
-}
 
-void ConsoleWidget::keyPressEvent( QKeyEvent* event )
-{
-#if defined( QT_6 )
-	const int bufferSize = static_cast < int >( commandBuffer.size() );
-#elif defined( QT_5 )
-	const int bufferSize = commandBuffer.size();
-#endif
+	const CommandHistory& history = core->GetHistory();
 
-	if ( event->key() == Qt::Key_Up )
+	if ( key == Qt::Key_Up )
 	{
-		if ( bufferIndex < bufferSize - 1 )
+		if ( historyIndex == -1 )
+			historyPrefix = ui->commandLineEdit->text();
+
+		if ( const int id = history.FindPrevious( historyPrefix, historyIndex == -1 ? history.GetEndId() : historyIndex ); id != -1 )
 		{
-			++bufferIndex;
-			ui->commandLineEdit->setText( commandBuffer[ bufferIndex ] );
+			historyIndex = id;
+			ui->commandLineEdit->setText( history.GetEntry( id ) );
 		}
 	}
-	else if ( event->key() == Qt::Key_Down )
+	else if ( key == Qt::Key_Down )
 	{
-		if ( bufferIndex > 0 )
+		if ( historyIndex == -1 )
 		{
-			--bufferIndex;
-			ui->commandLineEdit->setText( commandBuffer[ bufferIndex ] );
+			ui->commandLineEdit->clear();
+		}
+		else if ( const int id = history.FindNext( historyPrefix, historyIndex ); id != -1 )
+		{
+			historyIndex = id;
+			ui->commandLineEdit->setText( history.GetEntry( id ) );
 		}
 		else
 		{
-			ui->commandLineEdit->clear();
-			bufferIndex = -1;
+			ui->commandLineEdit->setText( historyPrefix );
+			historyIndex = -1;
 		}
 	}
 	else { QWidget::keyPressEvent( event ); }
 }
 
+bool ConsoleWidget::eventFilter( QObject* obj, QEvent* event )
+{
+	if ( obj == ui->consoleTextEdit->viewport() )
+	{
+		const QScrollBar* scrollBar = ui->consoleTextEdit->verticalScrollBar();
+
+		// Scrolling up at the top, the scroll bar does not move when the view fits or is already there
+		if ( event->type() == QEvent::Wheel && static_cast < QWheelEvent* >( event )->angleDelta().y() > 0 && scrollBar->value() == scrollBar->minimum() )
+			LoadOlderLines();
+
+		// Click on the expander of a long line
+		if ( event->type() == QEvent::MouseButtonRelease && !ui->consoleTextEdit->textCursor().hasSelection() )
+		{
+			if ( const auto* mouseEvent = static_cast < QMouseEvent* >( event ); mouseEvent->button() == Qt::LeftButton )
+			{
+				const QTextCursor cursor = ui->consoleTextEdit->cursorForPosition( mouseEvent->pos() );
+				const quint64 lineId = GetBlockLineId( cursor.blockNumber() );
+
+				if ( lineId < viewEndLineId && cursor.positionInBlock() >= LineData::LongLineLength )
+				{
+					if ( const LineData* line = core->FindLine( lineId ); line && line->IsLong() )
+						ExpandLine( line->Text, lineId );
+				}
+			}
+		}
+	}
+
+	return QWidget::eventFilter( obj, event );
+}
+
 void ConsoleWidget::OnCommandEntered()
 {
+	if ( historySearching )
+		StopHistorySearch( true );
+
 	const QString& command = ui->commandLineEdit->text();
 
 	if ( command.isEmpty() )
 		return;
 
-	if ( commandBuffer.empty() || commandBuffer.back() != command )
-		commandBuffer.push_front( command );
+	core->ExecuteCommand( command );
 
-	if ( commandBuffer.size() > MaxCommandBuffer )
-		commandBuffer.pop_back();
+	historyIndex = -1;
+	ui->commandLineEdit->clear();
+}
 
-	const QStringList args = command.split( ' ', Qt::SkipEmptyParts );
+void ConsoleWidget::CommandTextEdited()
+{
+	// While searching the line holds the query
+	if ( historySearching )
+		UpdateHistorySearch( core->GetHistory().GetEndId() );
+	else
+		historyIndex = -1;
+}
 
-	// command is the first argument ( args[ 0 ] )
-	if ( ConVarBase* conVar = ConVarManager::GetConVar( args[ 0 ] ) )
+void ConsoleWidget::SearchHistory()
+{
+	if ( !historySearching )
 	{
-		const int argCount = conVar->GetArgumentCount();
+		historySearching = true;
+		historyIndex = -1;
+		ui->historySearchLabel->show();
 
-		if ( args.size() < argCount + 1 )
-			ConVarManager::PrintInvalidArgument( this, conVar, args[ 0 ] );
-		else
-			conVar->Callback( conVar, args, this );
+		UpdateHistorySearch( core->GetHistory().GetEndId() );
+		return;
 	}
-	else
+
+	// Pressed again, look for an older match
+	if ( historySearchMatch != -1 )
+		UpdateHistorySearch( historySearchMatch );
+}
+
+void ConsoleWidget::OnLineAdded( const LineData& line )
+{
+	const quint64 lineId = core->GetEndLineId() - 1;
+
+	// A view left on older lines does not grow past MaxViewLines, scrolling down to its end loads the new ones.
+	// Lines of a batch are inserted at once when it finishes
+	if ( !batchStarted && viewEndLineId == lineId && ( IsAtBottom() || viewEndLineId - viewFirstLineId < MaxViewLines ) )
+		AppendToDocument( line );
+
+	// While the worker searches, the lines added after its snapshot are searched with its result
+	if ( !findSearch.IsEmpty() && !findRunning )
 	{
-		Print( ePrintType::PRINT_ERROR ) << QString( "Unknown command: %1" ).arg( args[ 0 ] );
-		Print( ePrintType::PRINT_INFO ) << QString( "Type 'help' for a list of available commands" );
+		LineFinder::FindInLine( findSearch, ui->findFullLinesCheckBox->isChecked(), line, lineId, findMatches );
+		UpdateFindResult();
 	}
+}
 
-	bufferIndex = -1;
-	ui->commandLineEdit->clear();
+void ConsoleWidget::OnFirstLineRemoved()
+{
+	// The line went to the scrollback, the view only keeps it when scrolled away from the newest lines
+	if ( !batchStarted && IsFollowing() && IsAtBottom() && viewFirstLineId < core->GetFirstLineId() )
+		RemoveFirstBlocks( static_cast < int >( core->GetFirstLineId() - viewFirstLineId ) );
+
+	if ( !findSearch.IsEmpty() )
+	{
+		RemoveOldFindMatches();
+		UpdateFindResult();
+	}
+}
+
+void ConsoleWidget::OnCleared()
+{
+	// Set first, clearing the document scrolls to the top
+	viewFirstLineId = core->GetEndLineId();
+	viewEndLineId = viewFirstLineId;
+
+	ui->consoleTextEdit->clear();
+
+	findMatches.clear();
+	currentFindMatch = -1;
+	UpdateFindResult();
+}
+
+void ConsoleWidget::OnBatchStarted()
+{
+	batchStarted = true;
+	batchAtBottom = IsAtBottom();
+	batchFollowing = IsFollowing();
+}
+
+void ConsoleWidget::OnBatchFinished()
+{
+	batchStarted = false;
+
+	if ( batchFollowing )
+		AppendNewLines( batchAtBottom );
 }
 
 void ConsoleWidget::SaveLogs()
@@ -255,7 +381,17 @@ void ConsoleWidget::SaveLogs()
 #elif defined( QT_5 )
 		out.setCodec( "UTF-8" );
 #endif
-		out << ui->consoleTextEdit->toPlainText();
+
+		// Older lines first, decompressed block by block
+		core->GetScrollback().ForEachLine( [ &out ]( const LineData& line, quint64 )
+		{
+			out << line.Text << '\n';
+			return true;
+		} );
+
+		// From the core, long lines are truncated in the document
+		for ( const LineData& line : core->GetLines() )
+			out << line.Text << '\n';
 	}
 }
 
@@ -265,72 +401,571 @@ void ConsoleWidget::TabPressed() const
 	ui->commandLineEdit->setFocus();
 }
 
-void ConsoleWidget::FilterChanged( const QString& filter ) const { UpdateConsoleColors(); }
+void ConsoleWidget::FilterChanged( const QString& filter )
+{
+	const bool textFilter = FilterEnabled() && !lineQuery.IsChannelOnly();
+	const quint64 previousChannels = highlighter->GetChannelFilter();
+
+	lineQuery = LineQuery::Parse( filter );
+	highlighter->SetQuery( lineQuery );
+	filterResult = {};
+
+	if ( FilterEnabled() && !lineQuery.IsChannelOnly() )
+	{
+		highlighter->SetChannelFilter( ConsoleHighlighter::AllChannels );
+
+		// The snapshots are implicitly shared, the worker never sees lines added or removed afterwards
+		lineFilter->Run( lineQuery, core->GetLines(), core->GetFirstLineId(), core->GetScrollback() );
+		highlighter->Restyle();
+		return;
+	}
+
+	// Channel terms are resolved by the highlighter from the channel of each line, there is nothing to scan
+	lineFilter->Cancel();
+	highlighter->SetChannelFilter( FilterEnabled() ? lineQuery.GetChannelMask() : ConsoleHighlighter::AllChannels );
+
+	if ( textFilter )
+		highlighter->Restyle();
+	else
+		RestyleChannels( previousChannels ^ highlighter->GetChannelFilter() );
+}
+
+void ConsoleWidget::FilterFinished( const LineFilterResult& result )
+{
+	// Kept whole, the highlighter looks up the blocks it styles
+	filterResult = result;
+	highlighter->Restyle();
+}
 
-void ConsoleWidget::RemoveFirstLine() const
+void ConsoleWidget::ShowFindBar()
 {
-	QTextCursor cursor( ui->consoleTextEdit->document() );
+	ui->findBarWidget->show();
+	ui->findLineEdit->setFocus();
+	ui->findLineEdit->selectAll();
+}
 
-	cursor.movePosition( QTextCursor::Start );
-	cursor.select( QTextCursor::LineUnderCursor );
-	cursor.removeSelectedText();
-	cursor.deleteChar();
+void ConsoleWidget::HideFindBar()
+{
+	ui->findBarWidget->hide();
+	ui->findLineEdit->clear();
+	ui->commandLineEdit->setFocus();
+}
+
+void ConsoleWidget::FindTextChanged( const QString& text )
+{
+	findSearch = TextSearch( text );
+	highlighter->SetSearch( findSearch );
+	highlighter->Restyle();
+	findMatches.clear();
+	currentFindMatch = -1;
+
+	// The lines are searched on the worker, matches are listed when it is done
+	findRunning = !findSearch.IsEmpty();
+
+	if ( findRunning )
+		lineFinder->Run( findSearch, ui->findFullLinesCheckBox->isChecked(), core->GetLines(), core->GetFirstLineId(), core->GetScrollback() );
+	else
+		lineFinder->Cancel();
+
+	UpdateFindResult();
+	UpdateFindHighlights();
 }
 
-void ConsoleWidget::UpdateConsoleColors() const
+void ConsoleWidget::FindFinished( const LineFinderResult& result )
 {
-	QStringList filters = ui->filterLineEdit->text().split( ',' );
+	findRunning = false;
+	findMatches = result.Matches;
 
-	for ( auto it = filters.begin(); it != filters.end(); )
+	// Lines added while the worker was searching
+	for ( quint64 lineId = result.EndLineId; lineId < core->GetEndLineId(); ++lineId )
 	{
-		if ( it->trimmed().size() < 2 )
-			it = filters.erase( it );
-		else
-			++it;
+		if ( const LineData* line = core->FindLine( lineId ) )
+			LineFinder::FindInLine( findSearch, ui->findFullLinesCheckBox->isChecked(), *line, lineId, findMatches );
+	}
+
+	// And the ones dropped from the scrollback or cleared meanwhile
+	RemoveOldFindMatches();
+
+	// Start from the first match visible in the console
+	if ( !findMatches.isEmpty() )
+	{
+		const quint64 firstVisibleLineId = GetBlockLineId( ui->consoleTextEdit->cursorForPosition( QPoint( 0, 0 ) ).blockNumber() );
+
+		const auto it = std::lower_bound( findMatches.begin(), findMatches.end(), firstVisibleLineId, []( const LineFindMatch& match, const quint64 lineId ) { return match.LineId < lineId; } );
+
+		SelectFindMatch( it == findMatches.end() ? 0 : static_cast < int >( it - findMatches.begin() ) );
+	}
+
+	UpdateFindResult();
+	UpdateFindHighlights();
+}
+
+void ConsoleWidget::FindNext()
+{
+	if ( findMatches.isEmpty() )
+		return;
+
+	SelectFindMatch( static_cast < int >( ( currentFindMatch + 1 ) % findMatches.size() ) );
+	UpdateFindResult();
+}
+
+void ConsoleWidget::FindPrevious()
+{
+	if ( findMatches.isEmpty() )
+		return;
+
+	SelectFindMatch( currentFindMatch <= 0 ? static_cast < int >( findMatches.size() ) - 1 : currentFindMatch - 1 );
+	UpdateFindResult();
+}
+
+void ConsoleWidget::UpdateFindHighlights() const
+{
+	QList < QTextEdit::ExtraSelection > selections;
+
+	// The other matches are styled by the highlighter
+	if ( currentFindMatch >= 0 && currentFindMatch < findMatches.size() )
+	{
+		if ( const QTextCursor cursor = GetFindMatchCursor( findMatches[ currentFindMatch ] ); !cursor.isNull() )
+		{
+			QTextEdit::ExtraSelection selection;
+			selection.cursor = cursor;
+			selection.format.setBackground( currentFindMatchColor );
+			selections.push_back( selection );
+		}
 	}
 
-	const bool filterEnabled = FilterEnabled() && !filters.isEmpty();
+	ui->consoleTextEdit->setExtraSelections( selections );
+}
+
+void ConsoleWidget::ShowSearch( const QString& text )
+{
+	ShowFindBar();
+	ui->findLineEdit->setText( text );
+}
+
+void ConsoleWidget::OnScrolled( const int value )
+{
+	if ( loadingLines )
+		return;
+
+	const QScrollBar* scrollBar = ui->consoleTextEdit->verticalScrollBar();
+
+	if ( value == scrollBar->minimum() )
+		LoadOlderLines();
+	else if ( value == scrollBar->maximum() )
+		LoadNewerLines();
+}
+
+void ConsoleWidget::AppendToDocument( const LineData& line )
+{
+	// Insert through a separate cursor so a selected find match is not lost, keep following the end when already there
+	const bool atBottom = IsAtBottom();
 
-	// Create a cursor for the QTextEdit
 	QTextCursor cursor( ui->consoleTextEdit->document() );
+	cursor.movePosition( QTextCursor::End );
+
+	if ( viewEndLineId > viewFirstLineId )
+		cursor.insertBlock();
+
+	cursor.insertText( GetDisplayText( line ) );
+	++viewEndLineId;
+
+	if ( viewEndLineId - viewFirstLineId > MaxViewLines )
+		RemoveFirstBlocks( 1 );
+
+	if ( atBottom )
+		ScrollToBottom();
+}
 
-	// Move to the start of the document
-	cursor.movePosition( QTextCursor::Start );
+void ConsoleWidget::AppendNewLines( const bool atBottom )
+{
+	const quint64 coreEnd = core->GetEndLineId();
 
-	for ( const auto& [ text, color, type ] : lines )
+	if ( !atBottom )
 	{
-		// Select the current line
-		cursor.select( QTextCursor::LineUnderCursor );
+		// Left on older lines, the view grows up to MaxViewLines
+		const quint64 end = std::min( coreEnd, viewFirstLineId + MaxViewLines );
 
-		QTextCharFormat format;
-		if ( filterEnabled )
+		if ( end > viewEndLineId )
 		{
-			bool matchFound = false;
-			for ( const QString& filter : filters )
-			{
-				if ( text.contains( filter.trimmed(), Qt::CaseInsensitive ) )
-				{
-					matchFound = true;
-					break;
-				}
-			}
+			QTextCursor cursor( ui->consoleTextEdit->document() );
+			cursor.movePosition( QTextCursor::End );
 
-			format.setForeground( matchFound ? color : disabledLineColor );
+			if ( viewEndLineId > viewFirstLineId )
+				cursor.insertBlock();
 
-			if ( matchFound )
-				format.setForeground( color );
-			else
-				format.setForeground( disabledLineColor );
+			cursor.insertText( GetViewText( viewEndLineId, end ) );
+			viewEndLineId = end;
 		}
-		else
+
+		return;
+	}
+
+	// Following the end, the view keeps the newest hot lines only
+	const quint64 first = std::max( { viewFirstLineId, core->GetFirstLineId(), coreEnd > MaxViewLines ? coreEnd - MaxViewLines : 0 } );
+
+	if ( first >= viewEndLineId )
+	{
+		// None of the shown lines are left, the lines that would be removed right away are never inserted
+		ResetView( first );
+	}
+	else
+	{
+		if ( first > viewFirstLineId )
+			RemoveFirstBlocks( static_cast < int >( first - viewFirstLineId ) );
+
+		if ( coreEnd > viewEndLineId )
+		{
+			QTextCursor cursor( ui->consoleTextEdit->document() );
+			cursor.movePosition( QTextCursor::End );
+			cursor.insertBlock();
+			cursor.insertText( GetViewText( viewEndLineId, coreEnd ) );
+			viewEndLineId = coreEnd;
+		}
+	}
+
+	ScrollToBottom();
+}
+
+void ConsoleWidget::ExpandLine( const QString& text, const quint64 lineId )
+{
+	// Laid out lazily block by block, copying from the viewer gives back the original text
+	auto* viewer = new LineViewer( text, this );
+	viewer->setWindowFlag( Qt::Window );
+	viewer->setAttribute( Qt::WA_DeleteOnClose );
+	viewer->setWindowTitle( tr( "Line %1" ).arg( lineId ) );
+	viewer->setFont( ui->consoleTextEdit->font() );
+	viewer->resize( 900, 600 );
+	viewer->show();
+}
+
+bool ConsoleWidget::IsAtBottom() const
+{
+	const QScrollBar* scrollBar = ui->consoleTextEdit->verticalScrollBar();
+
+	return scrollBar->value() == scrollBar->maximum();
+}
+
+void ConsoleWidget::ScrollToBottom() const
+{
+	QScrollBar* scrollBar = ui->consoleTextEdit->verticalScrollBar();
+
+	scrollBar->setValue( scrollBar->maximum() );
+}
+
+QString ConsoleWidget::GetDisplayText( const LineData& line ) const
+{
+	// Only the prefix of a long line is laid out, the expander opens the whole line
+	if ( !line.IsLong() )
+		return line.Text;
+
+	return line.Text.left( LineData::LongLineLength ) + tr( " ... [+%1 characters, click to expand]" ).arg( line.Text.size() - LineData::LongLineLength );
+}
+
+QString ConsoleWidget::GetViewText( const quint64 first, const quint64 end ) const
+{
+	QStringList texts;
+	texts.reserve( static_cast < int >( end - first ) );
+
+	// Consecutive lines of the scrollback come from the same cached blocks
+	for ( quint64 lineId = first; lineId < end; ++lineId )
+	{
+		const LineData* line = core->FindLine( lineId );
+		texts.push_back( line ? GetDisplayText( *line ) : QString() );
+	}
+
+	return texts.join( '\n' );
+}
+
+void ConsoleWidget::LoadOlderLines()
+{
+	const quint64 oldestLineId = core->GetOldestLineId();
+
+	if ( loadingLines || viewFirstLineId <= oldestLineId )
+		return;
+
+	loadingLines = true;
+
+	QScrollBar* scrollBar = ui->consoleTextEdit->verticalScrollBar();
+	const int value = scrollBar->value();
+
+	const quint64 first = viewFirstLineId - std::min < quint64 >( viewFirstLineId - oldestLineId, ViewPageLines );
+	const int count = static_cast < int >( viewFirstLineId - first );
+
+	QTextCursor cursor( ui->consoleTextEdit->document() );
+	cursor.beginEditBlock();
+	cursor.insertText( GetViewText( first, viewFirstLineId ) );
+
+	if ( viewEndLineId > viewFirstLineId )
+		cursor.insertBlock();
+
+	cursor.endEditBlock();
+	viewFirstLineId = first;
+
+	// Bounded, the newest lines are loaded again when scrolled back to
+	if ( viewEndLineId - viewFirstLineId > MaxViewLines )
+		RemoveLastBlocks( static_cast < int >( viewEndLineId - viewFirstLineId - MaxViewLines ) );
+
+	// Keep showing the same lines
+	scrollBar->setValue( value + count );
+
+	loadingLines = false;
+}
+
+void ConsoleWidget::LoadNewerLines()
+{
+	if ( loadingLines || IsFollowing() )
+		return;
+
+	// The lines after the view were dropped from the scrollback meanwhile
+	if ( viewEndLineId < core->GetOldestLineId() )
+	{
+		ResetView( core->GetOldestLineId() );
+		return;
+	}
+
+	loadingLines = true;
+
+	const quint64 end = std::min( core->GetEndLineId(), viewEndLineId + ViewPageLines );
+
+	QTextCursor cursor( ui->consoleTextEdit->document() );
+	cursor.beginEditBlock();
+	cursor.movePosition( QTextCursor::End );
+
+	if ( viewEndLineId > viewFirstLineId )
+		cursor.insertBlock();
+
+	cursor.insertText( GetViewText( viewEndLineId, end ) );
+	cursor.endEditBlock();
+	viewEndLineId = end;
+
+	if ( viewEndLineId - viewFirstLineId > MaxViewLines )
+		RemoveFirstBlocks( static_cast < int >( viewEndLineId - viewFirstLineId - MaxViewLines ) );
+
+	loadingLines = false;
+}
+
+void ConsoleWidget::ShowLine( const quint64 lineId )
+{
+	if ( lineId >= viewFirstLineId && lineId < viewEndLineId )
+		return;
+
+	// Loading every line in between could take the whole scrollback, the view starts over around the line
+	const quint64 first = lineId > ViewPageLines / 2 ? lineId - ViewPageLines / 2 : 0;
+	ResetView( std::max( first, core->GetOldestLineId() ) );
+}
+
+void ConsoleWidget::ResetView( const quint64 first )
+{
+	loadingLines = true;
+
+	// Up to the newest line when close enough, the view then follows new lines again
+	const quint64 coreEnd = core->GetEndLineId();
+	const quint64 end = coreEnd - first <= MaxViewLines ? coreEnd : first + ViewPageLines;
+
+	viewFirstLineId = first;
+	viewEndLineId = first;
+	ui->consoleTextEdit->clear();
+
+	QTextCursor cursor( ui->consoleTextEdit->document() );
+	cursor.insertText( GetViewText( first, end ) );
+	viewEndLineId = end;
+
+	loadingLines = false;
+}
+
+void ConsoleWidget::RemoveFirstBlocks( const int count )
+{
+	QScrollBar* scrollBar = ui->consoleTextEdit->verticalScrollBar();
+	const bool atBottom = IsAtBottom();
+	const int value = scrollBar->value();
+
+	const bool loading = std::exchange( loadingLines, true );
+
+	QTextDocument* document = ui->consoleTextEdit->document();
+	QTextCursor cursor( document );
+
+	if ( const QTextBlock block = document->findBlockByNumber( count ); block.isValid() )
+		cursor.setPosition( block.position(), QTextCursor::KeepAnchor );
+	else
+		cursor.movePosition( QTextCursor::End, QTextCursor::KeepAnchor );
+
+	cursor.removeSelectedText();
+	viewFirstLineId += count;
+
+	// The lines above the top of the viewport are gone, keep showing the same ones
+	if ( atBottom )
+		ScrollToBottom();
+	else
+		scrollBar->setValue( std::max( value - count, scrollBar->minimum() ) );
+
+	loadingLines = loading;
+}
+
+void ConsoleWidget::RemoveLastBlocks( const int count )
+{
+	QTextDocument* document = ui->consoleTextEdit->document();
+	const QTextBlock block = document->findBlockByNumber( document->blockCount() - count );
+
+	// With the separator before the first removed block
+	QTextCursor cursor( block );
+
+	if ( block.blockNumber() > 0 )
+		cursor.movePosition( QTextCursor::PreviousCharacter );
+
+	cursor.movePosition( QTextCursor::End, QTextCursor::KeepAnchor );
+	cursor.removeSelectedText();
+
+	viewEndLineId -= count;
+}
+
+void ConsoleWidget::UpdateHistorySearch( const int before )
+{
+	const CommandHistory& history = core->GetHistory();
+
+	// A new query starts from the newest entry, looking further back keeps the current match when nothing older is found
+	if ( const int id = history.Search( ui->commandLineEdit->text(), before ); id != -1 || before == history.GetEndId() )
+		historySearchMatch = id;
+
+	const QString match = historySearchMatch == -1 ? tr( "no match" ) : history.GetEntry( historySearchMatch );
+
+	ui->historySearchLabel->setText( tr( "History search [%1]" ).arg( match ) );
+}
+
+void ConsoleWidget::StopHistorySearch( const bool keepMatch )
+{
+	if ( keepMatch && historySearchMatch != -1 )
+		ui->commandLineEdit->setText( core->GetHistory().GetEntry( historySearchMatch ) );
+
+	historySearching = false;
+	historySearchMatch = -1;
+	ui->historySearchLabel->hide();
+}
+
+void ConsoleWidget::RemoveOldFindMatches()
+{
+	// Matches of the lines dropped from the scrollback
+	const quint64 oldestLineId = core->GetOldestLineId();
+	const auto end = std::lower_bound( findMatches.begin(), findMatches.end(), oldestLineId, []( const LineFindMatch& match, const quint64 lineId ) { return match.LineId < lineId; } );
+	const int count = static_cast < int >( end - findMatches.begin() );
+
+	if ( count == 0 )
+		return;
+
+	findMatches.erase( findMatches.begin(), end );
+	currentFindMatch = std::max( currentFindMatch - count, -1 );
+}
+
+void ConsoleWidget::SelectFindMatch( const int index )
+{
+	currentFindMatch = index;
+
+	ShowLine( findMatches[ index ].LineId );
+	ui->consoleTextEdit->setTextCursor( GetFindMatchCursor( findMatches[ index ] ) );
+	ui->consoleTextEdit->centerCursor();
+
+	UpdateFindHighlights();
+}
+
+void ConsoleWidget::UpdateFindResult() const
+{
+	if ( findSearch.IsEmpty() )
+		ui->findResultLabel->clear();
+	else if ( findRunning )
+		ui->findResultLabel->setText( tr( "Searching..." ) );
+	else if ( findMatches.isEmpty() )
+		ui->findResultLabel->setText( tr( "No results" ) );
+	else
+		ui->findResultLabel->setText( QString( "%1 / %2" ).arg( currentFindMatch + 1 ).arg( findMatches.size() ) );
+}
+
+QTextCursor ConsoleWidget::GetFindMatchCursor( const LineFindMatch& match ) const
+{
+	// Lines outside of the view have no block
+	if ( match.LineId < viewFirstLineId || match.LineId >= viewEndLineId )
+		return {};
+
+	const QTextBlock block = ui->consoleTextEdit->document()->findBlockByNumber( static_cast < int >( match.LineId - viewFirstLineId ) );
+
+	// Matches past the displayed prefix of a long line select its expander
+	const int blockEnd = block.length() - 1;
+	const int start = std::min( match.Position, blockEnd );
+	const int end = std::min( match.Position + static_cast < int >( findSearch.GetLength() ), blockEnd );
+
+	QTextCursor cursor( block );
+	cursor.setPosition( block.position() + start );
+	cursor.setPosition( block.position() + end, QTextCursor::KeepAnchor );
+
+	return cursor;
+}
+
+void ConsoleWidget::SetChannelHidden( const int channel, const bool hidden )
+{
+	if ( !LogChannels::IsValid( channel ) || IsChannelHidden( channel ) == hidden )
+		return;
+
+	highlighter->SetHiddenChannels( highlighter->GetHiddenChannels() ^ LogChannels::ChannelBit( channel ) );
+	RestyleChannels( LogChannels::ChannelBit( channel ) );
+}
+
+void ConsoleWidget::RestyleChannels( const quint64 channels ) const
+{
+	QList < int > blockNumbers;
+
+	// Lines of the scrollback have no channel index, only the few of them in the view are restyled
+	const quint64 firstHotLineId = std::clamp( core->GetFirstLineId(), viewFirstLineId, viewEndLineId );
+
+	for ( quint64 lineId = viewFirstLineId; lineId < firstHotLineId; ++lineId )
+		blockNumbers.push_back( static_cast < int >( lineId - viewFirstLineId ) );
+
+	// Found from the channel indexes, the lines of the other channels are not touched
+	for ( int channel = 0; channel < LogChannels::MaxChannels; ++channel )
+	{
+		if ( !( channels & LogChannels::ChannelBit( channel ) ) )
+			continue;
+
+		for ( const quint64 lineId : core->GetChannelLines( channel ) )
 		{
-			format.setForeground( color ); // Assuming default color is black
+			if ( lineId >= viewFirstLineId && lineId < viewEndLineId )
+				blockNumbers.push_back( static_cast < int >( lineId - viewFirstLineId ) );
 		}
+	}
+
+	highlighter->RestyleBlocks( blockNumbers );
+}
+
+bool ConsoleWidget::LineMatches( const LineData& line, const quint64 lineId ) const
+{
+	// Channel filters are applied by the highlighter
+	if ( !FilterEnabled() || lineQuery.IsChannelOnly() )
+		return true;
+
+	if ( filterResult.Generation == lineFilter->GetGeneration() && lineId >= filterResult.FirstLineId && lineId - filterResult.FirstLineId < static_cast < quint64 >( filterResult.Matches.size() ) )
+		return filterResult.Matches.testBit( static_cast < int >( lineId - filterResult.FirstLineId ) );
+
+	// Added after the snapshot or while the query runs, only the blocks being styled get here
+	return lineQuery.Matches( line );
+}
+
+QColor ConsoleWidget::GetLineColor( const int index ) const
+{
+	const quint64 lineId = GetBlockLineId( index );
+	const LineData* line = lineId < viewEndLineId ? core->FindLine( lineId ) : nullptr;
+
+	// The empty block of an empty view, or a line dropped from the scrollback since it was loaded
+	if ( !line )
+		return printColors[ ePrintType::PRINT_INFO ];
+
+	return highlighter->IsChannelShown( line->Channel ) && LineMatches( *line, lineId ) ? printColors[ line->Type ] : disabledLineColor;
+}
 
-		// Apply the format to the current line
-		cursor.setCharFormat( format );
+void ConsoleWidget::SetPrintColor( const ePrintType type, const QColor& color )
+{
+	printColors[ type ] = color;
 
-		// Move to the next line
-		cursor.movePosition( QTextCursor::NextBlock );
+	for ( const ConsoleWidget* console : consoles )
+	{
+		if ( console )
+			console->highlighter->Restyle();
 	}
 }
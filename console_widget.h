@@ -1,12 +1,15 @@
-#pragma once
+﻿#pragma once
 
 #include <QStandardItemModel>
 
 #include "console_widget_global.h"
 #include "utils/const.h"
 
-#include "objects/line_data/line_data.h"
-#include "objects/console_printer/console_printer.h"
+#include "objects/console_core/console_core.h"
+#include "objects/console_highlighter/console_highlighter.h"
+#include "objects/line_filter/line_filter.h"
+#include "objects/line_finder/line_finder.h"
+#include "objects/text_search/text_search.h"
 
 #include "ui_console_widget.h"
 
@@ -23,11 +26,25 @@ class CONSOLE_WIDGET_EXPORT ConsoleWidget final : public QWidget
 {
 	Q_OBJECT public:
 	explicit ConsoleWidget( QWidget* parent = nullptr );
+	~ConsoleWidget() override;
 
-	ConsolePrinter Print( const ePrintType type = ePrintType::PRINT_INFO ) { return ConsolePrinter( this, type ); }
+	ConsolePrinter Print( const ePrintType type = ePrintType::PRINT_INFO ) const { return core->Print( type ); }
+	ConsolePrinter Print( const int channel, const ePrintType type = ePrintType::PRINT_INFO ) const { return core->Print( channel, type ); }
 
-	void AddLine( const QString& line, ePrintType type = ePrintType::PRINT_INFO );
-	void Clear();
+	void AddLine( const QString& line, const ePrintType type = ePrintType::PRINT_INFO, const int channel = LogChannels::DefaultChannel ) const { core->AddLine( line, type, channel ); }
+	void AddLines( const QList < QueuedLine >& batch ) const { core->AddLines( batch ); }
+	void Clear() const { core->Clear(); }
+
+	[[nodiscard]] ConsoleCore* GetCore() const { return core; }
+
+	// The first console opens GetDefaultHistoryFile(), an empty path stops keeping the history
+	bool SetHistoryFile( const QString& path ) const { return core->SetHistoryFile( path ); }
+	[[nodiscard]] QString GetHistoryFile() const { return core->GetHistoryFile(); }
+	[[nodiscard]] static QString GetDefaultHistoryFile();
+
+	// Grays out the lines of a channel in this console only, LogChannels::SetMuted stops them from being printed at all
+	void SetChannelHidden( int channel, bool hidden );
+	[[nodiscard]] bool IsChannelHidden( const int channel ) const { return LogChannels::IsValid( channel ) && ( highlighter->GetHiddenChannels() & LogChannels::ChannelBit( channel ) ) != 0; }
 
 	void SetupFonts( const QFont& consoleFont, const QFont& commandFont, const QFont& completerFont ) const;
 	void SetupConsoleFont( const QFont& font ) const { ui->consoleTextEdit->setFont( font ); }
@@ -38,38 +55,106 @@ class CONSOLE_WIDGET_EXPORT ConsoleWidget final : public QWidget
 
 	static QList < ConsoleWidget* > GetConsoles() { return consoles; }
 
-	static GlobalConsolePrinter PrintGlobal( const ePrintType type = ePrintType::PRINT_INFO ) { return GlobalConsolePrinter( type ); }
+	static GlobalConsolePrinter PrintGlobal( const ePrintType type = ePrintType::PRINT_INFO ) { return ConsoleCore::PrintGlobal( type ); }
+	static GlobalConsolePrinter PrintGlobal( const int channel, const ePrintType type = ePrintType::PRINT_INFO ) { return ConsoleCore::PrintGlobal( channel, type ); }
 
-	static void SetPrintColor( const ePrintType type, const QColor& color ) { printColors[ type ] = color; }
+	static void SetPrintColor( ePrintType type, const QColor& color );
 	static QColor GetPrintColor( const ePrintType type ) { return printColors[ type ]; }
 
 	static void SetupConsolesFonts( const QFont& font, const QFont& commandFont, const QFont& completerFont );
 
-	static void UpdateConsolesCommands();
+	static void UpdateConsolesCommands() { ConsoleCore::UpdateConsolesCommands(); }
 
 protected:
 	void keyPressEvent( QKeyEvent* event ) override;
+	bool eventFilter( QObject* obj, QEvent* event ) override;
 
 private slots:
 	void OnCommandEntered();
+	void CommandTextEdited();
+	void SearchHistory();
+	void OnLineAdded( const LineData& line );
+	void OnFirstLineRemoved();
+	void OnCleared();
+	void OnBatchStarted();
+	void OnBatchFinished();
 	void SaveLogs();
 	void TabPressed() const;
-	void FilterChanged( const QString& filter ) const;
+	void FilterChanged( const QString& filter );
+	void FilterFinished( const LineFilterResult& result );
+	void ShowFindBar();
+	void HideFindBar();
+	void FindTextChanged( const QString& text );
+	void FindFinished( const LineFinderResult& result );
+	void FindNext();
+	void FindPrevious();
+	void UpdateFindHighlights() const;
+	void ShowSearch( const QString& text );
+	void OnScrolled( int value );
 
 private:
 	Ui::ConsoleWidgetClass* ui;
+	ConsoleCore* core;
 	ConsoleCompleter* completer = nullptr;
+	ConsoleHighlighter* highlighter = nullptr;
 	QStandardItemModel* completerModel;
 
-	QStringList commandBuffer;
-	int bufferIndex = -1;
-
-	QList < LineData > lines;
-
-	void RemoveFirstLine() const;
-	[[nodiscard]] bool FilterEnabled() const { return !ui->filterLineEdit->text().isEmpty(); }
-
-	void UpdateConsoleColors() const;
+	int historyIndex = -1; // Entry shown with Up / Down, -1 when not browsing the history
+	QString historyPrefix; // Text typed before browsing, only the entries starting with it are shown
+
+	bool historySearching = false;
+	int historySearchMatch = -1;
+
+	// Set between BatchStarted and BatchFinished, the lines of a batch are inserted at once
+	bool batchStarted = false;
+	bool batchAtBottom = false;
+	bool batchFollowing = false;
+
+	// The document shows the lines [ viewFirstLineId, viewEndLineId ), block n being the line viewFirstLineId + n.
+	// Lines of the scrollback are loaded when scrolled to, new lines are appended while the view reaches the end of the core
+	quint64 viewFirstLineId = 0;
+	quint64 viewEndLineId = 0;
+	bool loadingLines = false;
+
+	LineFilter* lineFilter;
+	LineQuery lineQuery;
+	LineFilterResult filterResult; // Latest result of the worker, looked up for the blocks being styled
+
+	LineFinder* lineFinder;
+	TextSearch findSearch;
+	QList < LineFindMatch > findMatches; // Sorted by line id then position
+	int currentFindMatch = -1;
+	bool findRunning = false; // The worker is looking for findSearch, findMatches fills up when it is done
+
+	void AppendToDocument( const LineData& line );
+	void AppendNewLines( bool atBottom );
+	void ExpandLine( const QString& text, quint64 lineId );
+	[[nodiscard]] bool IsAtBottom() const;
+	void ScrollToBottom() const;
+
+	[[nodiscard]] bool IsFollowing() const { return viewEndLineId == core->GetEndLineId(); }
+	[[nodiscard]] quint64 GetBlockLineId( const int blockNumber ) const { return viewFirstLineId + static_cast < quint64 >( blockNumber ); }
+	[[nodiscard]] QString GetDisplayText( const LineData& line ) const;
+	[[nodiscard]] QString GetViewText( quint64 first, quint64 end ) const;
+	void LoadOlderLines();
+	void LoadNewerLines();
+	void ShowLine( quint64 lineId );
+	void ResetView( quint64 first );
+	void RemoveFirstBlocks( int count );
+	void RemoveLastBlocks( int count );
+
+	void UpdateHistorySearch( int before );
+	void StopHistorySearch( bool keepMatch );
+
+	void RemoveOldFindMatches();
+	void SelectFindMatch( int index );
+	void UpdateFindResult() const;
+	[[nodiscard]] QTextCursor GetFindMatchCursor( const LineFindMatch& match ) const;
+	[[nodiscard]] bool FilterEnabled() const { return !lineQuery.IsEmpty(); }
+
+	void RestyleChannels( quint64 channels ) const;
+	[[nodiscard]] bool LineMatches( const LineData& line, quint64 lineId ) const;
+	[[nodiscard]] QColor GetLineColor( int index ) const;
 
 	inline static QMap < ePrintType, QColor > printColors = {
 		{ ePrintType::PRINT_INFO, QColor( "#4A90E2" ) }, // Blue light
@@ -81,8 +166,9 @@ private:
 
 	inline static QList < ConsoleWidget* > consoles;
 
-	inline static QColor disabledLineColor = { "#D3D3D3" }; // Light gray
+	static constexpr int ViewPageLines = 500; // Loaded at once when scrolling past an end of the view
+	static constexpr int MaxViewLines = 20 * ViewPageLines;
 
-	static constexpr int MaxCommandBuffer = 16;
-	static constexpr int MaxLineCount = 1000;
+	inline static QColor disabledLineColor = { "#D3D3D3" }; // Light gray
+	inline static QColor currentFindMatchColor = { "#FFB347" }; // Orange pastel
 };
@@ -0,0 +1,312 @@
+#include "command_history.h"
+
+#include <algorithm>
+#include <functional>
+
+#include <QSaveFile>
+
+#include "utils/defines.h"
+
+#include "objects/text_search/text_search.h"
+
+CommandHistory::CommandHistory( const int maxEntries ) : maxEntries( std::max( maxEntries, 1 ) ) {}
+
+bool CommandHistory::Open( const QString& path )
+{
+	// Only the commands of the new file are kept
+	Close();
+	Clear();
+
+	if ( QFile input( path ); input.exists() )
+	{
+		if ( !input.open( QIODevice::ReadOnly ) )
+			return false;
+
+		const QByteArray data = input.readAll();
+
+#if defined( QT_6 )
+		const int size = static_cast < int >( data.size() );
+#elif defined( QT_5 )
+		const int size = data.size();
+#endif
+
+		for ( int start = 0; start < size; )
+		{
+			int end = static_cast < int >( data.indexOf( '\n', start ) );
+			if ( end == -1 )
+				end = size;
+
+			int length = end - start;
+			if ( length > 0 && data.at( end - 1 ) == '\r' )
+				--length;
+
+			if ( length > 0 )
+			{
+				Insert( QString::fromUtf8( data.constData() + start, length ), false );
+				++fileLineCount;
+			}
+
+			start = end + 1;
+		}
+
+		// Sorted once instead of inserting every entry
+		BuildPrefixIndex();
+	}
+
+	file.setFileName( path );
+
+	if ( fileLineCount > GetStaleLimit() * 2 )
+		return RewriteFile();
+
+	return file.open( QIODevice::WriteOnly | QIODevice::Append );
+}
+
+void CommandHistory::Close()
+{
+	file.close();
+	fileLineCount = 0;
+}
+
+void CommandHistory::Add( const QString& command )
+{
+	if ( command.trimmed().isEmpty() )
+		return;
+
+	// One command per line in the file
+	QString entry = command;
+	entry.replace( '\n', ' ' );
+
+	if ( !Insert( entry ) || !file.isOpen() )
+		return;
+
+	file.write( entry.toUtf8().append( '\n' ) );
+	file.flush();
+
+	if ( ++fileLineCount > GetStaleLimit() * 2 )
+		RewriteFile();
+}
+
+void CommandHistory::Clear()
+{
+	entries.clear();
+	ids.clear();
+	liveCount = 0;
+	firstLive = 0;
+	prefixIndex.clear();
+	searchDirty = true;
+	prefixMatchesDirty = true;
+
+	if ( file.isOpen() )
+	{
+		file.resize( 0 );
+		fileLineCount = 0;
+	}
+}
+
+QStringList CommandHistory::GetEntries() const
+{
+	QStringList list;
+	list.reserve( liveCount );
+
+	for ( int id = firstLive; id < GetEndId(); ++id )
+	{
+		if ( !entries[ id ].isNull() )
+			list.push_back( entries[ id ] );
+	}
+
+	return list;
+}
+
+int CommandHistory::FindPrevious( const QString& prefix, const int before ) const
+{
+	const QList < int >& matches = GetPrefixMatches( prefix );
+	const auto it = std::lower_bound( matches.begin(), matches.end(), before );
+
+	return it == matches.begin() ? -1 : *( it - 1 );
+}
+
+int CommandHistory::FindNext( const QString& prefix, const int after ) const
+{
+	const QList < int >& matches = GetPrefixMatches( prefix );
+	const auto it = std::upper_bound( matches.begin(), matches.end(), after );
+
+	return it == matches.end() ? -1 : *it;
+}
+
+int CommandHistory::Search( const QString& text, const int before ) const
+{
+	const TextSearch search( text );
+
+	if ( search.IsEmpty() )
+		return -1;
+
+	if ( searchDirty )
+		BuildSearchText();
+
+	// Ids decrease along the text, start at the first entry older than before
+	const auto piece = std::upper_bound( searchIds.begin(), searchIds.end(), before, std::greater <>() );
+
+	if ( piece == searchIds.end() )
+		return -1;
+
+	const qsizetype position = search.IndexIn( searchText, searchStarts[ piece - searchIds.begin() ] );
+
+	if ( position < 0 )
+		return -1;
+
+	const auto start = std::upper_bound( searchStarts.begin(), searchStarts.end(), position ) - 1;
+
+	return searchIds[ start - searchStarts.begin() ];
+}
+
+bool CommandHistory::Insert( const QString& command, const bool updateIndex )
+{
+	if ( const auto it = ids.constFind( command ); it != ids.constEnd() )
+	{
+		// Already the newest entry, nothing changes
+		if ( it.value() == GetEndId() - 1 )
+			return false;
+
+		// Same entry, same place in the index
+		if ( updateIndex )
+			*FindInPrefixIndex( command ) = GetEndId();
+
+		entries[ it.value() ] = QString();
+		--liveCount;
+	}
+	else if ( updateIndex )
+	{
+		prefixIndex.insert( FindInPrefixIndex( command ), GetEndId() );
+	}
+
+	ids.insert( command, GetEndId() );
+	entries.push_back( command );
+	++liveCount;
+
+	while ( liveCount > maxEntries )
+	{
+		while ( entries[ firstLive ].isNull() )
+			++firstLive;
+
+		if ( updateIndex )
+			prefixIndex.erase( FindInPrefixIndex( entries[ firstLive ] ) );
+		ids.remove( entries[ firstLive ] );
+		entries[ firstLive++ ] = QString();
+		--liveCount;
+	}
+
+	if ( GetEndId() - liveCount > GetStaleLimit() )
+		Compact();
+
+	searchDirty = true;
+	prefixMatchesDirty = true;
+	return true;
+}
+
+void CommandHistory::Compact()
+{
+	QStringList live;
+	live.reserve( liveCount );
+	ids.clear();
+
+	for ( int id = firstLive; id < GetEndId(); ++id )
+	{
+		if ( entries[ id ].isNull() )
+			continue;
+
+		ids.insert( entries[ id ], static_cast < int >( live.size() ) );
+		live.push_back( entries[ id ] );
+	}
+
+	entries = live;
+	firstLive = 0;
+
+	// Every id changed
+	BuildPrefixIndex();
+}
+
+bool CommandHistory::RewriteFile()
+{
+	const QString path = file.fileName();
+	file.close();
+
+	QSaveFile output( path );
+	bool saved = output.open( QIODevice::WriteOnly );
+
+	if ( saved )
+	{
+		for ( const QString& entry : GetEntries() )
+			output.write( entry.toUtf8().append( '\n' ) );
+
+		saved = output.commit();
+	}
+
+	if ( saved )
+		fileLineCount = liveCount;
+
+	return file.open( QIODevice::WriteOnly | QIODevice::Append ) && saved;
+}
+
+void CommandHistory::BuildSearchText() const
+{
+	searchText.clear();
+	searchStarts.clear();
+	searchIds.clear();
+
+	searchStarts.reserve( liveCount );
+	searchIds.reserve( liveCount );
+
+	for ( int id = GetEndId() - 1; id >= firstLive; --id )
+	{
+		if ( entries[ id ].isNull() )
+			continue;
+
+		searchStarts.push_back( searchText.size() );
+		searchIds.push_back( id );
+
+		// Commands never contain a line feed, a match can not span two entries
+		searchText.append( entries[ id ] );
+		searchText.append( '\n' );
+	}
+
+	searchDirty = false;
+}
+
+const QList < int >& CommandHistory::GetPrefixMatches( const QString& prefix ) const
+{
+	if ( !prefixMatchesDirty && prefixMatchesPrefix == prefix )
+		return prefixMatches;
+
+	// Binary search of the index for the range, then only its ids are sorted
+	const auto first = std::lower_bound( prefixIndex.begin(), prefixIndex.end(), prefix, [ this ]( const int id, const QString& entry ) { return entries[ id ] < entry; } );
+	const auto last = std::partition_point( first, prefixIndex.end(), [ this, &prefix ]( const int id ) { return entries[ id ].startsWith( prefix ); } );
+
+	prefixMatches = QList < int >( first, last );
+	std::sort( prefixMatches.begin(), prefixMatches.end() );
+
+	prefixMatchesPrefix = prefix;
+	prefixMatchesDirty = false;
+
+	return prefixMatches;
+}
+
+QList < int >::iterator CommandHistory::FindInPrefixIndex( const QString& entry )
+{
+	// Live entries are unique, the lower bound is the entry itself or where it goes
+	return std::lower_bound( prefixIndex.begin(), prefixIndex.end(), entry, [ this ]( const int id, const QString& other ) { return entries[ id ] < other; } );
+}
+
+void CommandHistory::BuildPrefixIndex()
+{
+	prefixIndex.clear();
+	prefixIndex.reserve( liveCount );
+
+	for ( int id = firstLive; id < GetEndId(); ++id )
+	{
+		if ( !entries[ id ].isNull() )
+			prefixIndex.push_back( id );
+	}
+
+	std::sort( prefixIndex.begin(), prefixIndex.end(), [ this ]( const int a, const int b ) { return entries[ a ] < entries[ b ]; } );
+	prefixMatchesDirty = true;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+
+#include <QFile>
+#include <QHash>
+#include <QStringList>
+
+#include "console_widget_global.h"
+
+// Command history of a console, oldest entries first.
+// Running a command again moves it to the end instead of adding a duplicate, the oldest entries are dropped past the capacity.
+// Entries are addressed by ids, which stay valid until the next Add or Clear.
+// Once a file is opened every command is appended to it, the file is rewritten when it holds too many stale lines.
+class CONSOLE_WIDGET_EXPORT CommandHistory final
+{
+public:
+	explicit CommandHistory( int maxEntries = DefaultMaxEntries );
+
+	// Loads the file then keeps appending to it, returns false when it can not be opened
+	bool Open( const QString& path );
+	void Close();
+
+	[[nodiscard]] QString GetPath() const { return file.isOpen() ? file.fileName() : QString(); }
+
+	void Add( const QString& command );
+	void Clear();
+
+	[[nodiscard]] int GetCount() const { return liveCount; }
+	[[nodiscard]] int GetEndId() const { return static_cast < int >( entries.size() ); }
+	[[nodiscard]] QString GetEntry( const int id ) const { return id >= 0 && id < GetEndId() ? entries[ id ] : QString(); }
+	[[nodiscard]] QStringList GetEntries() const;
+
+	// Newest entry before the id starting with prefix, GetEndId() starts from the newest entry. Returns -1 when there is none
+	[[nodiscard]] int FindPrevious( const QString& prefix, int before ) const;
+	// Oldest entry after the id starting with prefix, -1 when there is none
+	[[nodiscard]] int FindNext( const QString& prefix, int after ) const;
+	// Newest entry before the id containing text, case insensitive. Returns -1 when there is none
+	[[nodiscard]] int Search( const QString& text, int before ) const;
+
+	static constexpr int DefaultMaxEntries = 100000;
+
+private:
+	QStringList entries; // Null strings are entries moved to the end or dropped
+	QHash < QString, int > ids;
+	int liveCount = 0;
+	int firstLive = 0;
+	int maxEntries;
+
+	QFile file;
+	int fileLineCount = 0;
+
+	// Live ids sorted by entry, the entries starting with a prefix are a contiguous range of it
+	QList < int > prefixIndex;
+
+	// Ids of the entries starting with prefixMatchesPrefix in increasing order, built on the first lookup of a prefix after a change
+	mutable QString prefixMatchesPrefix;
+	mutable QList < int > prefixMatches;
+	mutable bool prefixMatchesDirty = true;
+
+	// Live entries joined newest first, rebuilt on the first search after a change and scanned in one pass
+	mutable QString searchText;
+	mutable QList < qsizetype > searchStarts;
+	mutable QList < int > searchIds;
+	mutable bool searchDirty = true;
+
+	bool Insert( const QString& command, bool updateIndex = true ); // Without updateIndex, BuildPrefixIndex must be called after
+	void Compact();
+	bool RewriteFile();
+	void BuildSearchText() const;
+
+	[[nodiscard]] const QList < int >& GetPrefixMatches( const QString& prefix ) const;
+	[[nodiscard]] QList < int >::iterator FindInPrefixIndex( const QString& entry );
+	void BuildPrefixIndex();
+
+	[[nodiscard]] int GetStaleLimit() const { return std::max( liveCount, MinCompactSize ); }
+
+	static constexpr int MinCompactSize = 1024;
+};
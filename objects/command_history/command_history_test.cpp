@@ -0,0 +1,186 @@
+#include "command_history_test.h"
+
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "command_history.h"
+
+// Every entry starting with prefix, newest first, walked with FindPrevious
+static QStringList WalkPrevious( const CommandHistory& history, const QString& prefix )
+{
+	QStringList found;
+
+	for ( int id = history.FindPrevious( prefix, history.GetEndId() ); id != -1; id = history.FindPrevious( prefix, id ) )
+		found.push_back( history.GetEntry( id ) );
+
+	return found;
+}
+
+// Oldest first, walked with FindNext
+static QStringList WalkNext( const CommandHistory& history, const QString& prefix )
+{
+	QStringList found;
+
+	for ( int id = history.FindNext( prefix, -1 ); id != -1; id = history.FindNext( prefix, id ) )
+		found.push_back( history.GetEntry( id ) );
+
+	return found;
+}
+
+void CommandHistoryTest::AddMovesDuplicates()
+{
+	CommandHistory history;
+	history.Add( "help" );
+	history.Add( "clear" );
+	history.Add( "help" );
+	history.Add( "help" );
+	history.Add( "  " );
+	history.Add( "multi\nline" );
+
+	QCOMPARE( history.GetCount(), 3 );
+	QCOMPARE( history.GetEntries(), QStringList( { "clear", "help", "multi line" } ) );
+}
+
+void CommandHistoryTest::PrefixLookup()
+{
+	CommandHistory history;
+
+	for ( const char* command : { "set fps 60", "help", "set vsync 1", "sv_cheats 1", "set fps 144", "s", "set" } )
+		history.Add( command );
+
+	// Moved to the end, its old place is not found anymore
+	history.Add( "help" );
+
+	QCOMPARE( WalkPrevious( history, "set" ), QStringList( { "set", "set fps 144", "set vsync 1", "set fps 60" } ) );
+	QCOMPARE( WalkNext( history, "set" ), QStringList( { "set fps 60", "set vsync 1", "set fps 144", "set" } ) );
+	QCOMPARE( WalkPrevious( history, "s" ), QStringList( { "set", "s", "set fps 144", "sv_cheats 1", "set vsync 1", "set fps 60" } ) );
+	QCOMPARE( WalkPrevious( history, "" ).size(), 7 );
+	QCOMPARE( WalkPrevious( history, "" ).front(), QString( "help" ) );
+	QVERIFY( WalkPrevious( history, "x" ).isEmpty() );
+	QVERIFY( WalkPrevious( history, "set fps 1440" ).isEmpty() );
+
+	// The index follows the entries added after a lookup
+	history.Add( "set gamma 2" );
+	QCOMPARE( WalkPrevious( history, "set " ).front(), QString( "set gamma 2" ) );
+
+	history.Clear();
+	QCOMPARE( history.FindPrevious( "", history.GetEndId() ), -1 );
+	QCOMPARE( history.FindNext( "", -1 ), -1 );
+}
+
+void CommandHistoryTest::Capacity()
+{
+	CommandHistory history( 3 );
+
+	for ( const char* command : { "a1", "b1", "a2", "b2", "a3" } )
+		history.Add( command );
+
+	QCOMPARE( history.GetEntries(), QStringList( { "a2", "b2", "a3" } ) );
+	QCOMPARE( WalkPrevious( history, "a" ), QStringList( { "a3", "a2" } ) );
+	QCOMPARE( WalkNext( history, "b" ), QStringList( { "b2" } ) );
+}
+
+void CommandHistoryTest::Compaction()
+{
+	CommandHistory history;
+	history.Add( "first" );
+
+	// Running the same two commands over and over leaves stale ids until the entries are compacted
+	for ( int i = 0; i < 10000; ++i )
+		history.Add( i % 2 == 0 ? "even" : "odd" );
+
+	QVERIFY( history.GetEndId() < 10000 );
+	QCOMPARE( history.GetEntries(), QStringList( { "first", "even", "odd" } ) );
+	QCOMPARE( WalkPrevious( history, "" ), QStringList( { "odd", "even", "first" } ) );
+	QCOMPARE( WalkNext( history, "e" ), QStringList( { "even" } ) );
+}
+
+void CommandHistoryTest::Search()
+{
+	CommandHistory history;
+
+	for ( const char* command : { "connect localhost", "SET name Player", "disconnect", "set Volume 1" } )
+		history.Add( command );
+
+	const int newest = history.Search( "CONNECT", history.GetEndId() );
+	QCOMPARE( history.GetEntry( newest ), QString( "disconnect" ) );
+	QCOMPARE( history.GetEntry( history.Search( "connect", newest ) ), QString( "connect localhost" ) );
+	QCOMPARE( history.GetEntry( history.Search( "set", history.GetEndId() ) ), QString( "set Volume 1" ) );
+	QCOMPARE( history.Search( "nothing", history.GetEndId() ), -1 );
+}
+
+void CommandHistoryTest::FileRoundTrip()
+{
+	const QTemporaryDir dir;
+	const QString path = dir.filePath( "history.txt" );
+
+	{
+		CommandHistory history;
+		QVERIFY( history.Open( path ) );
+		QCOMPARE( history.GetPath(), path );
+
+		history.Add( "help" );
+		history.Add( "set fps 60" );
+		history.Add( "help" );
+	}
+
+	CommandHistory history;
+	QVERIFY( history.Open( path ) );
+
+	// The moved entry keeps its latest place
+	QCOMPARE( history.GetEntries(), QStringList( { "set fps 60", "help" } ) );
+	QCOMPARE( WalkPrevious( history, "set" ), QStringList( { "set fps 60" } ) );
+
+	history.Clear();
+	history.Close();
+
+	QVERIFY( history.Open( path ) );
+	QCOMPARE( history.GetCount(), 0 );
+}
+
+void CommandHistoryTest::OpenReplacesEntries()
+{
+	const QTemporaryDir dir;
+	const QString firstPath = dir.filePath( "first.txt" );
+	const QString secondPath = dir.filePath( "second.txt" );
+
+	CommandHistory history;
+	QVERIFY( history.Open( firstPath ) );
+	history.Add( "from first" );
+
+	QVERIFY( history.Open( secondPath ) );
+	QCOMPARE( history.GetCount(), 0 );
+	history.Add( "from second" );
+
+	QVERIFY( history.Open( firstPath ) );
+	QCOMPARE( history.GetEntries(), QStringList( { "from first" } ) );
+
+	QVERIFY( history.Open( secondPath ) );
+	QCOMPARE( history.GetEntries(), QStringList( { "from second" } ) );
+}
+
+void CommandHistoryTest::LargeHistory()
+{
+	CommandHistory history;
+
+	for ( int i = 0; i < CommandHistory::DefaultMaxEntries; ++i )
+		history.Add( QString( "command %1 %2" ).arg( i % 100 ).arg( i ) );
+
+	// Browsing a prefix with Up then Down, the first lookup builds the range of the prefix
+	QElapsedTimer timer;
+	timer.start();
+
+	int id = history.GetEndId();
+	int count = 0;
+
+	for ( ; count < 1000; ++count )
+		id = history.FindPrevious( "command 42 ", id );
+
+	for ( int i = 0; i < 1000; ++i )
+		id = history.FindNext( "command 42 ", id );
+
+	QVERIFY( timer.elapsed() < 200 );
+	QCOMPARE( id, -1 );
+	QCOMPARE( WalkPrevious( history, "command 42 " ).size(), CommandHistory::DefaultMaxEntries / 100 );
+}
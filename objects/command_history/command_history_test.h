@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QObject>
+
+class CommandHistoryTest final : public QObject
+{
+	Q_OBJECT private slots:
+	void AddMovesDuplicates();
+	void PrefixLookup();
+	void Capacity();
+	void Compaction();
+	void Search();
+	void FileRoundTrip();
+	void OpenReplacesEntries();
+	void LargeHistory();
+};
@@ -1,5 +1,14 @@
 #include "con_var.h"
 
+#include <algorithm>
+#include <vector>
+
+#include <QFileInfo>
+
+#include "objects/con_var_batch/con_var_batch.h"
+#include "objects/file_tail/file_tail.h"
+#include "objects/text_search/text_search.h"
+
 ConVarBase::ConVarBase( const QString& name ) { this->name = name; }
 
 template < typename T >
@@ -19,47 +28,159 @@ eCVarType ConVar < T >::GetType( const ConVarBase* var )
 	return eCVarType::STRING;
 }
 
+static QString FromView( const std::u16string_view view )
+{
+	if ( view.empty() )
+		return {};
+
+	return QString::fromRawData( reinterpret_cast < const QChar* >( view.data() ), static_cast < int >( view.size() ) );
+}
+
+static QStringList SplitArguments( const std::u16string_view arguments )
+{
+	QStringList list;
+
+	for ( std::size_t start = 0; start < arguments.size(); )
+	{
+		const std::size_t end = std::min( arguments.find( u' ', start ), arguments.size() );
+
+		if ( end > start )
+			list.push_back( FromView( arguments.substr( start, end - start ) ) );
+
+		start = end + 1;
+	}
+
+	return list;
+}
+
+template < typename T >
+static ConVar < T >* ApplyRange( ConVar < T >* var, const ConVarDescriptor& descriptor )
+{
+	if ( descriptor.MinValue )
+		var->SetMinValue( static_cast < T >( *descriptor.MinValue ) );
+	if ( descriptor.MaxValue )
+		var->SetMaxValue( static_cast < T >( *descriptor.MaxValue ) );
+
+	return var;
+}
+
 void ConVarManager::ConVarInit()
 {
-	RegisterBoolConVar( "clear", false, "Clear the console", &ConVarManager::ClearConsoleCallback );
+	static constexpr ConVarDescriptor BuiltinConVars[] =
+	{
+		{ .Name = u"clear", .Type = eCVarType::BOOL, .Description = u"Clear the console", .Callback = &ConVarManager::ClearConsoleCallback },
+		{ .Name = u"help", .Type = eCVarType::BOOL, .Description = u"Gives all available commands", .Callback = &ConVarManager::HelpCallback },
+		{ .Name = u"history_file", .Type = eCVarType::BOOL, .Description = u"Show the file keeping the command history of this console, or keep it in the given file", .Callback = &ConVarManager::HistoryFileCallback },
+		{ .Name = u"print", .Type = eCVarType::BOOL, .Description = u"Print a message in this console", .Callback = &ConVarManager::PrintCallback, .Arguments = u"message_string" },
+		{ .Name = u"scrollback", .Type = eCVarType::BOOL, .Description = u"Show the scrollback size, or find the older lines containing a text", .Callback = &ConVarManager::ScrollbackCallback },
+		{ .Name = u"set", .Type = eCVarType::BOOL, .Description = u"Set one or more variables at once, every value must be valid or nothing changes", .Callback = &ConVarManager::SetValuesCallback, .Arguments = u"name value" },
+		{ .Name = u"tail", .Type = eCVarType::BOOL, .Description = u"Follow a log file in this console, -raw keeps every line as info", .Callback = &ConVarManager::TailCallback, .Arguments = u"path" },
+		{ .Name = u"tail_stop", .Type = eCVarType::BOOL, .Description = u"Stop following a log file, or every file when no path is given", .Callback = &ConVarManager::TailStopCallback },
+	};
+
+	RegisterConVars( BuiltinConVars );
+
 	RegisterAlias( "cls", "clear" );
+	RegisterAlias( "say", "print" );
+}
 
-	RegisterBoolConVar( "help", false, "Gives all available commands", &ConVarManager::HelpCallback );
+int ConVarManager::RegisterConVars( const std::span < const ConVarDescriptor > descriptors )
+{
+	int registered = 0;
 
-	RegisterBoolConVar( "print", false, "Print a message in this console", &ConVarManager::PrintCallback, QStringList( "message_string" ) );
-	RegisterAlias( "say", "print" );
+	for ( const ConVarDescriptor& descriptor : descriptors )
+	{
+		const QString name = FromView( descriptor.Name );
+		ConVarBase* var = nullptr;
+
+		switch ( descriptor.Type )
+		{
+		case eCVarType::STRING:
+			var = CreateConVar < QString >( name, FromView( descriptor.DefaultString ) );
+			break;
+		case eCVarType::INT:
+			var = ApplyRange( CreateConVar < int >( name, descriptor.DefaultInt ), descriptor );
+			break;
+		case eCVarType::FLOAT:
+			var = ApplyRange( CreateConVar < float >( name, descriptor.DefaultFloat ), descriptor );
+			break;
+		case eCVarType::BOOL:
+			var = CreateConVar < bool >( name, descriptor.DefaultBool );
+			break;
+		}
+
+		var->SetDescription( FromView( descriptor.Description ) );
+		var->SetIsVariable( descriptor.IsVariable );
+
+		if ( descriptor.Callback )
+			var->SetCallback( descriptor.Callback );
+
+		if ( !descriptor.Arguments.empty() )
+			var->SetArguments( SplitArguments( descriptor.Arguments ) );
+
+		if ( InsertConVar( var ) )
+			++registered;
+	}
+
+	return registered;
 }
 
-void ConVarManager::RegisterConVar( ConVarBase* var )
+void ConVarManager::RegisterConVar( ConVarBase* var ) { InsertConVar( var ); }
+
+bool ConVarManager::InsertConVar( ConVarBase* var )
 {
-	const QString name = var->GetName();
-	if ( GetConVars().contains( name ) )
+	Registry& registry = GetRegistry();
+
+	if ( const auto [ it, inserted ] = registry.ConVars.try_emplace( var->GetName(), var ); !inserted )
 	{
-		ConsoleWidget::PrintGlobal( ePrintType::PRINT_ERROR ) << "ConVarManager::RegisterConVar() ConVar" << name << "already exists!";
-		return;
+		ConsoleCore::PrintGlobal( ePrintType::PRINT_ERROR ) << "ConVarManager::RegisterConVar() ConVar" << var->GetName() << "already exists!";
+		DestroyConVar( var, registry.ConVarArena );
+		return false;
 	}
 
-	conVars[ name ] = var;
+	return true;
+}
+
+void ConVarManager::DestroyConVar( ConVarBase* var, std::pmr::memory_resource& arena )
+{
+	if ( !var->arenaAllocated )
+		delete var;
+	else if ( auto* stringVar = dynamic_cast < ConVar < QString >* >( var ) )
+		DestroyArenaConVar( stringVar, arena );
+	else if ( auto* intVar = dynamic_cast < ConVar < int >* >( var ) )
+		DestroyArenaConVar( intVar, arena );
+	else if ( auto* floatVar = dynamic_cast < ConVar < float >* >( var ) )
+		DestroyArenaConVar( floatVar, arena );
+	else if ( auto* boolVar = dynamic_cast < ConVar < bool >* >( var ) )
+		DestroyArenaConVar( boolVar, arena );
 }
 
 void ConVarManager::RegisterAlias( const QString& alias, const QString& originalName )
 {
-	if ( auto* conVar = GetConVar( originalName ); conVar && !conVars.contains( alias ) )
-		conVars.insert( { alias, conVar } );
+	if ( auto* conVar = GetConVar( originalName ); conVar && !GetRegistry().ConVars.contains( alias ) )
+	{
+		GetRegistry().ConVars.insert( { alias, conVar } );
+		return;
+	}
 
-	ConsoleWidget::PrintGlobal( ePrintType::PRINT_ERROR ) << "ConVarManager::RegisterAlias() Alias" << alias << "for" << originalName << "already exists!";
+	ConsoleCore::PrintGlobal( ePrintType::PRINT_ERROR ) << "ConVarManager::RegisterAlias() Alias" << alias << "for" << originalName << "already exists!";
 }
 
-ConVar < float >* ConVarManager::RegisterFloatConVar( const QString& name, const float defaultValue, const QString& description, const ConVarCallback& callback, const QStringList& args, const bool isVariable )
+template < typename T >
+ConVar < T >* ConVarManager::SetupConVar( ConVar < T >* var, const QString& description, const ConVarCallback& callback, const QStringList& args, const bool isVariable )
 {
-	ConVar < float >* var = new ConVar( name, defaultValue );
 	var->SetDescription( description );
 	var->SetCallback( callback );
 	var->SetIsVariable( isVariable );
 	var->SetArguments( args );
-	RegisterConVar( var );
 
-	return var;
+	// A duplicate is freed right away
+	return InsertConVar( var ) ? var : nullptr;
+}
+
+ConVar < float >* ConVarManager::RegisterFloatConVar( const QString& name, const float defaultValue, const QString& description, const ConVarCallback& callback, const QStringList& args, const bool isVariable )
+{
+	return SetupConVar( CreateConVar < float >( name, defaultValue ), description, callback, args, isVariable );
 }
 
 ConVar < float >* ConVarManager::RegisterFloatConVar( const QString& name, const float defaultValue, const QString& description, const ConVarCallback& callback, const bool isVariable )
@@ -69,14 +190,7 @@ ConVar < float >* ConVarManager::RegisterFloatConVar( const QString& name, const
 
 ConVar < int >* ConVarManager::RegisterIntConVar( const QString& name, const int defaultValue, const QString& description, const ConVarCallback& callback, const QStringList& args, const bool isVariable )
 {
-	ConVar < int >* var = new ConVar( name, defaultValue );
-	var->SetDescription( description );
-	var->SetCallback( callback );
-	var->SetIsVariable( isVariable );
-	var->SetArguments( args );
-	RegisterConVar( var );
-
-	return var;
+	return SetupConVar( CreateConVar < int >( name, defaultValue ), description, callback, args, isVariable );
 }
 
 ConVar < int >* ConVarManager::RegisterIntConVar( const QString& name, const int defaultValue, const QString& description, const ConVarCallback& callback, const bool isVariable )
@@ -86,14 +200,7 @@ ConVar < int >* ConVarManager::RegisterIntConVar( const QString& name, const int
 
 ConVar < bool >* ConVarManager::RegisterBoolConVar( const QString& name, const bool defaultValue, const QString& description, const ConVarCallback& callback, const QStringList& args, const bool isVariable )
 {
-	ConVar < bool >* var = new ConVar( name, defaultValue );
-	var->SetDescription( description );
-	var->SetCallback( callback );
-	var->SetIsVariable( isVariable );
-	var->SetArguments( args );
-	RegisterConVar( var );
-
-	return var;
+	return SetupConVar( CreateConVar < bool >( name, defaultValue ), description, callback, args, isVariable );
 }
 
 ConVar < bool >* ConVarManager::RegisterBoolConVar( const QString& name, const bool defaultValue, const QString& description, const ConVarCallback& callback, const bool isVariable )
@@ -103,14 +210,7 @@ ConVar < bool >* ConVarManager::RegisterBoolConVar( const QString& name, const b
 
 ConVar < QString >* ConVarManager::RegisterStringConVar( const QString& name, const QString& defaultValue, const QString& description, const ConVarCallback& callback, const QStringList& args, const bool isVariable )
 {
-	ConVar < QString >* var = new ConVar( name, defaultValue );
-	var->SetDescription( description );
-	var->SetCallback( callback );
-	var->SetIsVariable( isVariable );
-	var->SetArguments( args );
-	RegisterConVar( var );
-
-	return var;
+	return SetupConVar( CreateConVar < QString >( name, defaultValue ), description, callback, args, isVariable );
 }
 
 ConVar < QString >* ConVarManager::RegisterStringConVar( const QString& name, const QString& defaultValue, const QString& description, const ConVarCallback& callback, const bool isVariable )
@@ -120,11 +220,57 @@ ConVar < QString >* ConVarManager::RegisterStringConVar( const QString& name, co
 
 void ConVarManager::UnregisterConVar( const QString& name )
 {
-	if ( const auto* conVar = GetConVar( name ); conVar )
-		conVars.erase( name );
+	Registry& registry = GetRegistry();
+
+	const auto it = registry.ConVars.find( name );
+	if ( it == registry.ConVars.end() )
+		return;
+
+	ConVarBase* conVar = it->second;
+
+	// Only an alias, the ConVar stays registered under its other names
+	if ( conVar->GetName() != name )
+	{
+		registry.ConVars.erase( it );
+		return;
+	}
+
+	std::erase_if( registry.ConVars, [ conVar ]( const auto& entry ) { return entry.second == conVar; } );
+	DestroyConVar( conVar, registry.ConVarArena );
+}
+
+void ConVarManager::Shutdown() { GetRegistry().Clear(); }
+
+ConVarManager::Registry& ConVarManager::GetRegistry()
+{
+	static Registry registry;
+	return registry;
+}
+
+void ConVarManager::Registry::Clear()
+{
+	{
+		// Aliases share their ConVar, each one is destroyed once
+		std::vector < ConVarBase* > unique;
+		unique.reserve( ConVars.size() );
+
+		for ( const auto& [ name, var ] : ConVars )
+			unique.push_back( var );
+
+		std::sort( unique.begin(), unique.end() );
+		unique.erase( std::unique( unique.begin(), unique.end() ), unique.end() );
+
+		ConVars.clear();
+
+		for ( ConVarBase* var : unique )
+			DestroyConVar( var, ConVarArena );
+	}
+
+	ConVarArena.release();
+	MapArena.release();
 }
 
-bool ConVarManager::PrintInvalidArgument( ConsoleWidget* console, const ConVarBase* var, const QString& conVarName )
+bool ConVarManager::PrintInvalidArgument( ConsoleCore* console, const ConVarBase* var, const QString& conVarName )
 {
 	if ( !console )
 		return false;
@@ -141,8 +287,10 @@ bool ConVarManager::PrintInvalidArgument( ConsoleWidget* console, const ConVarBa
 
 ConVarBase* ConVarManager::GetConVar( const QString& name )
 {
-	if ( conVars.contains( name ) )
-		return conVars.at( name );
+	const ConVarMap& conVars = GetConVars();
+
+	if ( const auto it = conVars.find( name ); it != conVars.end() )
+		return it->second;
 
 	return nullptr;
 }
@@ -180,7 +328,7 @@ QString ConVarManager::GetConVarValueString( const QString& name )
 }
 
 // Callbacks
-bool ConVarManager::ClearConsoleCallback( ConVarBase*, const QStringList&, ConsoleWidget* console )
+bool ConVarManager::ClearConsoleCallback( ConVarBase*, const QStringList&, ConsoleCore* console )
 {
 	if ( console )
 		console->Clear();
@@ -188,7 +336,7 @@ bool ConVarManager::ClearConsoleCallback( ConVarBase*, const QStringList&, Conso
 	return console;
 }
 
-bool ConVarManager::HelpCallback( ConVarBase*, const QStringList&, ConsoleWidget* console )
+bool ConVarManager::HelpCallback( ConVarBase*, const QStringList&, ConsoleCore* console )
 {
 	console->Print() << "--------------------COMMANDS--------------------";
 	for ( const auto& [ key, value ] : GetConVars() )
@@ -205,7 +353,7 @@ bool ConVarManager::HelpCallback( ConVarBase*, const QStringList&, ConsoleWidget
 	return console;
 }
 
-bool ConVarManager::PrintCallback( ConVarBase*, const QStringList& args, ConsoleWidget* console )
+bool ConVarManager::PrintCallback( ConVarBase*, const QStringList& args, ConsoleCore* console )
 {
 	const QStringList sublist = args.mid( 1 );
 
@@ -214,3 +362,149 @@ bool ConVarManager::PrintCallback( ConVarBase*, const QStringList& args, Console
 
 	return console;
 }
+
+bool ConVarManager::ScrollbackCallback( ConVarBase*, const QStringList& args, ConsoleCore* console )
+{
+	if ( !console )
+		return false;
+
+	const Scrollback& scrollback = console->GetScrollback();
+
+	if ( args.size() < 2 )
+	{
+		const ScrollbackStats stats = scrollback.GetStats();
+
+		console->Print() << QString( "Scrollback: %1 lines, %2 KiB stored for %3 KiB of UTF-8 records ( compression ratio %4 )" ).arg( stats.LineCount ).arg( stats.StoredBytes / 1024 ).arg( stats.RawBytes / 1024 ).arg( stats.GetRatio(), 0, 'f', 2 );
+		return true;
+	}
+
+	// Only counted here, the consoles show the matching lines where they are instead of printing them again
+	const QString text = args.mid( 1 ).join( " " );
+	const TextSearch search( text );
+
+	qint64 matchCount = 0;
+	quint64 firstMatch = 0;
+	quint64 lastMatch = 0;
+
+	scrollback.ForEachLine( [ & ]( const LineData& line, const quint64 lineId )
+	{
+		if ( search.IsFoundIn( line.Text ) )
+		{
+			if ( matchCount++ == 0 )
+				firstMatch = lineId;
+
+			lastMatch = lineId;
+		}
+
+		return true;
+	} );
+
+	if ( matchCount == 0 )
+		console->Print() << QString( "No match in the scrollback" );
+	else
+		console->Print() << QString( "%1 matching lines in the scrollback, from line %2 to %3" ).arg( matchCount ).arg( firstMatch ).arg( lastMatch );
+
+	emit console->SearchRequested( text );
+
+	return true;
+}
+
+bool ConVarManager::TailCallback( ConVarBase*, const QStringList& args, ConsoleCore* console )
+{
+	if ( !console )
+		return false;
+
+	const bool raw = args.size() > 1 && args[ 1 ] == "-raw";
+	const QString path = args.mid( raw ? 2 : 1 ).join( " " );
+
+	if ( path.isEmpty() )
+	{
+		console->Print( ePrintType::PRINT_ERROR ) << "tail: a path is required";
+		return false;
+	}
+
+	if ( !QFileInfo( path ).isFile() && QFileInfo::exists( path ) )
+	{
+		console->Print( ePrintType::PRINT_ERROR ) << QString( "tail: %1 is not a file" ).arg( path );
+		return false;
+	}
+
+	const QString absolutePath = QFileInfo( path ).absoluteFilePath();
+
+	for ( const FileTail* tail : console->findChildren < FileTail* >() )
+	{
+		if ( tail->GetPath() == absolutePath )
+		{
+			console->Print( ePrintType::PRINT_WARNING ) << QString( "tail: already following %1" ).arg( absolutePath );
+			return false;
+		}
+	}
+
+	// Owned by the console, stopped with it
+	new FileTail( absolutePath, !raw, console );
+	return true;
+}
+
+bool ConVarManager::TailStopCallback( ConVarBase*, const QStringList& args, ConsoleCore* console )
+{
+	if ( !console )
+		return false;
+
+	const QString path = args.mid( 1 ).join( " " );
+	const QString absolutePath = path.isEmpty() ? QString() : QFileInfo( path ).absoluteFilePath();
+	int stopped = 0;
+
+	for ( FileTail* tail : console->findChildren < FileTail* >() )
+	{
+		if ( absolutePath.isEmpty() || tail->GetPath() == absolutePath )
+		{
+			console->Print( ePrintType::PRINT_NOTICE ) << QString( "tail: stopped following %1" ).arg( tail->GetPath() );
+			delete tail;
+			++stopped;
+		}
+	}
+
+	if ( stopped == 0 )
+		console->Print( ePrintType::PRINT_WARNING ) << ( path.isEmpty() ? QString( "tail: no file is followed" ) : QString( "tail: %1 is not followed" ).arg( path ) );
+
+	return stopped > 0;
+}
+
+bool ConVarManager::SetValuesCallback( ConVarBase* var, const QStringList& args, ConsoleCore* console )
+{
+	// Name value pairs
+	if ( args.size() % 2 == 0 )
+		return PrintInvalidArgument( console, var, args[ 0 ] );
+
+	ConVarBatch batch( console );
+
+	// Every pair is parsed so that all the invalid ones are reported, Commit then rolls back
+	for ( int i = 1; i + 1 < args.size(); i += 2 )
+		batch.SetText( args[ i ], args[ i + 1 ] );
+
+	return batch.Commit();
+}
+
+bool ConVarManager::HistoryFileCallback( ConVarBase*, const QStringList& args, ConsoleCore* console )
+{
+	if ( !console )
+		return false;
+
+	if ( args.size() < 2 )
+	{
+		const QString path = console->GetHistoryFile();
+		console->Print() << ( path.isEmpty() ? QString( "The command history is not kept in a file" ) : QString( "Command history file: %1" ).arg( path ) );
+		return true;
+	}
+
+	const QString path = args.mid( 1 ).join( " " );
+
+	if ( !console->SetHistoryFile( path ) )
+	{
+		console->Print( ePrintType::PRINT_ERROR ) << QString( "Could not open the history file %1" ).arg( path );
+		return false;
+	}
+
+	console->Print( ePrintType::PRINT_NOTICE ) << QString( "Command history file: %1" ).arg( path );
+	return true;
+}
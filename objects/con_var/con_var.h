@@ -1,8 +1,13 @@
 #pragma once
 
 #include <functional>
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string_view>
 
-#include "../../console_widget.h"
+#include "../console_core/console_core.h"
 #include "../../utils/const.h"
 
 class ConVarBase;
@@ -31,7 +36,7 @@ public:
 #elif defined( QT_5 )
 	[[nodiscard]] int GetArgumentCount() const { return arguments.size(); }
 #endif
-	bool Callback( ConVarBase* var, const QStringList& args, ConsoleWidget* console ) const { return callback( var, args, console ); }
+	bool Callback( ConVarBase* var, const QStringList& args, ConsoleCore* console ) const { return callback( var, args, console ); }
 
 	void SetName( const QString& nameStr ) { name = nameStr; }
 	void SetDescription( const QString& helpStr ) { description = helpStr; }
@@ -46,6 +51,11 @@ protected:
 	QStringList arguments;
 
 	ConVarCallback callback;
+
+private:
+	friend class ConVarManager;
+
+	bool arenaAllocated = false; // Allocated by ConVarManager, otherwise created with new
 };
 
 template < typename T >
@@ -60,15 +70,16 @@ public:
 	[[nodiscard]] T GetMinValue() const { return minValue; }
 	[[nodiscard]] bool HasMaxValue() const { return hasMaxValue; }
 	[[nodiscard]] T GetMaxValue() const { return maxValue; }
+	[[nodiscard]] bool IsInRange( const T& newValue ) const { return !( HasMinValue() && newValue < GetMinValue() || HasMaxValue() && newValue > GetMaxValue() ); }
 
-	void SetValue( const T& newValue, ConsoleWidget* console )
+	void SetValue( const T& newValue, ConsoleCore* console )
 	{
 		if ( newValue == value )
 			return;
 
 		if ( console )
 		{
-			if ( HasMinValue() && newValue < GetMinValue() || HasMaxValue() && newValue > GetMaxValue() )
+			if ( !IsInRange( newValue ) )
 			{
 				console->Print( ePrintType::PRINT_ERROR ) << U8( "ConVar::SetValue() Error: Value is out of range, expected between %1 - %2" ).arg( QString::number( GetMinValue() ) ).arg( QString::number( GetMaxValue() ) );
 				return;
@@ -122,10 +133,37 @@ private:
 	inline static const auto ConVarChangeMessage = U8( "ConVar [%1] changed: %2 => %3" );
 };
 
+// Declarative ConVar definition, meant to be listed in a static constexpr table and registered with ConVarManager::RegisterConVars.
+// Strings must be u"" literals, they are used in place without being copied.
+struct ConVarDescriptor
+{
+	std::u16string_view Name;
+	eCVarType Type = eCVarType::BOOL;
+	std::u16string_view Description;
+	ConVarCallbackFunction Callback = nullptr;
+	std::u16string_view Arguments; // Space separated argument names
+	bool IsVariable = false;
+
+	// Only the field matching Type is used
+	int DefaultInt = 0;
+	float DefaultFloat = 0.0f;
+	bool DefaultBool = false;
+	std::u16string_view DefaultString;
+
+	// INT and FLOAT only
+	std::optional < double > MinValue;
+	std::optional < double > MaxValue;
+};
+
 class ConVarManager final
 {
 public:
 	static void ConVarInit();
+
+	// Registers every descriptor in one pass and returns how many were added, duplicates are reported and skipped
+	static int RegisterConVars( std::span < const ConVarDescriptor > descriptors );
+
+	// Takes ownership of var, which must have been created with new
 	static void RegisterConVar( ConVarBase* var );
 	static void RegisterAlias( const QString& alias, const QString& originalName );
 
@@ -138,11 +176,17 @@ public:
 	static ConVar < QString >* RegisterStringConVar( const QString& name, const QString& defaultValue, const QString& description, const ConVarCallback& callback, const QStringList& args = {}, bool isVariable = false );
 	static ConVar < QString >* RegisterStringConVar( const QString& name, const QString& defaultValue, const QString& description, const ConVarCallback& callback, bool isVariable );
 
+	// Unregistering a ConVar by its name also removes its aliases and frees it
 	static void UnregisterConVar( const QString& name );
 
-	static bool PrintInvalidArgument( ConsoleWidget* console, const ConVarBase* var, const QString& conVarName );
+	// Frees every registered ConVar, pointers returned by the Register functions become invalid. Done at exit when not called
+	static void Shutdown();
+
+	static bool PrintInvalidArgument( ConsoleCore* console, const ConVarBase* var, const QString& conVarName );
 
-	static const auto& GetConVars() { return conVars; }
+	using ConVarMap = std::pmr::map < QString, ConVarBase* >;
+
+	static const ConVarMap& GetConVars() { return GetRegistry().ConVars; }
 
 	[[nodiscard]] static ConVarBase* GetConVar( const QString& name );
 
@@ -156,7 +200,7 @@ public:
 	}
 
 	template < typename T >
-	static void SetConVarValue( const QString& name, T newValue, ConsoleWidget* console = nullptr )
+	static void SetConVarValue( const QString& name, T newValue, ConsoleCore* console = nullptr )
 	{
 		if ( ConVar < T >* var = GetConVar < T >( name ); var )
 			var->SetValue( newValue, console );
@@ -168,9 +212,49 @@ public:
 	[[nodiscard]] static QString GetConVarValueString( const QString& name );
 
 private:
-	inline static std::map < QString, ConVarBase* > conVars;
+	// ConVars and map nodes are carved out of pooled blocks instead of one heap allocation each.
+	// Built on first use, so ConVars can be registered from other static initializers, and the ConVars left are freed at exit
+	struct Registry
+	{
+		std::pmr::unsynchronized_pool_resource ConVarArena;
+		std::pmr::unsynchronized_pool_resource MapArena;
+		ConVarMap ConVars { &MapArena };
+
+		~Registry() { Clear(); }
 
-	static bool ClearConsoleCallback( ConVarBase*, const QStringList&, ConsoleWidget* );
-	static bool HelpCallback( ConVarBase*, const QStringList&, ConsoleWidget* );
-	static bool PrintCallback( ConVarBase*, const QStringList&, ConsoleWidget* );
+		void Clear();
+	};
+
+	static Registry& GetRegistry();
+
+	template < typename T >
+	static ConVar < T >* CreateConVar( const QString& name, const T& defaultValue )
+	{
+		auto* var = new( GetRegistry().ConVarArena.allocate( sizeof( ConVar < T > ), alignof( ConVar < T > ) ) ) ConVar < T >( name, defaultValue );
+		var->arenaAllocated = true;
+
+		return var;
+	}
+
+	template < typename T >
+	static void DestroyArenaConVar( ConVar < T >* var, std::pmr::memory_resource& arena )
+	{
+		std::destroy_at( var );
+		arena.deallocate( var, sizeof( ConVar < T > ), alignof( ConVar < T > ) );
+	}
+
+	template < typename T >
+	static ConVar < T >* SetupConVar( ConVar < T >* var, const QString& description, const ConVarCallback& callback, const QStringList& args, bool isVariable );
+
+	static bool InsertConVar( ConVarBase* var );
+	static void DestroyConVar( ConVarBase* var, std::pmr::memory_resource& arena );
+
+	static bool ClearConsoleCallback( ConVarBase*, const QStringList&, ConsoleCore* );
+	static bool HelpCallback( ConVarBase*, const QStringList&, ConsoleCore* );
+	static bool PrintCallback( ConVarBase*, const QStringList&, ConsoleCore* );
+	static bool ScrollbackCallback( ConVarBase*, const QStringList&, ConsoleCore* );
+	static bool TailCallback( ConVarBase*, const QStringList&, ConsoleCore* );
+	static bool TailStopCallback( ConVarBase*, const QStringList&, ConsoleCore* );
+	static bool SetValuesCallback( ConVarBase*, const QStringList&, ConsoleCore* );
+	static bool HistoryFileCallback( ConVarBase*, const QStringList&, ConsoleCore* );
 };
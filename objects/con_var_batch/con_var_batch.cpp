@@ -0,0 +1,211 @@
+#include "con_var_batch.h"
+
+#include <algorithm>
+
+#include "objects/con_var/con_var.h"
+
+static QString ToText( const QString& value ) { return value; }
+static QString ToText( const bool value ) { return value ? "true" : "false"; }
+static QString ToText( const int value ) { return QString::number( value ); }
+static QString ToText( const float value ) { return QString::number( value ); }
+
+bool ConVarBatch::SetText( const QString& name, const QString& text )
+{
+	// Errors of the values staged before are kept, Commit reports them all
+	StartBatch();
+
+	const ConVarBase* var = ConVarManager::GetConVar( name );
+
+	if ( !var )
+	{
+		AddError( QString( "Unknown ConVar: %1" ).arg( name ) );
+		return false;
+	}
+
+	bool ok = true;
+	Value newValue = text;
+
+	if ( dynamic_cast < const ConVar < int >* >( var ) )
+	{
+		newValue = text.toInt( &ok );
+	}
+	else if ( dynamic_cast < const ConVar < float >* >( var ) )
+	{
+		newValue = text.toFloat( &ok );
+	}
+	else if ( dynamic_cast < const ConVar < bool >* >( var ) )
+	{
+		ok = text == "1" || text == "0" || text.compare( "true", Qt::CaseInsensitive ) == 0 || text.compare( "false", Qt::CaseInsensitive ) == 0;
+		newValue = text == "1" || text.compare( "true", Qt::CaseInsensitive ) == 0;
+	}
+
+	if ( ok )
+		Stage( name, newValue );
+	else
+		AddError( QString( "Invalid value for %1: %2" ).arg( name, text ) );
+
+	return ok;
+}
+
+bool ConVarBatch::Commit()
+{
+	StartBatch();
+	committed = true;
+
+	// Values SetText rejected were never staged, they still reject the batch
+	const int rejectedCount = static_cast < int >( errors.size() );
+
+	// Aliases and names staged twice end up on the same ConVar, the last value wins
+	QList < QPair < ConVarBase*, Value > > resolved;
+
+	for ( const auto& [ name, stagedValue ] : staged )
+	{
+		ConVarBase* var = ConVarManager::GetConVar( name );
+
+		if ( !var )
+		{
+			AddError( QString( "Unknown ConVar: %1" ).arg( name ) );
+			continue;
+		}
+
+		const Value newValue = Convert( var, stagedValue );
+
+		if ( const QString error = Validate( var, newValue ); !error.isEmpty() )
+		{
+			AddError( error );
+			continue;
+		}
+
+		const auto it = std::find_if( resolved.begin(), resolved.end(), [ var ]( const QPair < ConVarBase*, Value >& entry ) { return entry.first == var; } );
+
+		if ( it != resolved.end() )
+			it->second = newValue;
+		else
+			resolved.push_back( { var, newValue } );
+	}
+
+	const int valueCount = GetStagedCount() + rejectedCount;
+	staged.clear();
+
+	if ( !errors.isEmpty() )
+	{
+		if ( console )
+			console->Print( ePrintType::PRINT_ERROR ) << QString( "ConVar batch rolled back, %1 of %2 values rejected" ).arg( errors.size() ).arg( valueCount );
+
+		return false;
+	}
+
+	// Every value was validated, nothing can fail from here
+	QStringList changes;
+
+	for ( const auto& [ var, newValue ] : resolved )
+	{
+		if ( QString change; Apply( var, newValue, change ) )
+			changes.push_back( change );
+	}
+
+	if ( changes.isEmpty() )
+		return true;
+
+	if ( console )
+	{
+		QString summary = changes.mid( 0, MaxSummaryChanges ).join( ", " );
+
+		if ( changes.size() > MaxSummaryChanges )
+			summary += QString( ", %1 more" ).arg( changes.size() - MaxSummaryChanges );
+
+		console->Print( ePrintType::PRINT_NOTICE ) << QString( "ConVar batch: %1 changed ( %2 )" ).arg( changes.size() ).arg( summary );
+	}
+
+	ConsoleCore::UpdateConsolesCommands();
+	return true;
+}
+
+void ConVarBatch::Clear()
+{
+	staged.clear();
+	errors.clear();
+	committed = false;
+}
+
+void ConVarBatch::StartBatch()
+{
+	if ( !committed )
+		return;
+
+	errors.clear();
+	committed = false;
+}
+
+void ConVarBatch::Stage( const QString& name, const Value& value )
+{
+	StartBatch();
+
+	const auto it = std::find_if( staged.begin(), staged.end(), [ &name ]( const StagedValue& entry ) { return entry.Name == name; } );
+
+	if ( it != staged.end() )
+		it->NewValue = value;
+	else
+		staged.push_back( { name, value } );
+}
+
+void ConVarBatch::AddError( const QString& error )
+{
+	errors.push_back( error );
+
+	if ( console )
+		console->Print( ePrintType::PRINT_ERROR ) << error;
+}
+
+ConVarBatch::Value ConVarBatch::Convert( const ConVarBase* var, const Value& value )
+{
+	// Widened like the assignment would, the other types must match
+	if ( const int* intValue = std::get_if < int >( &value ); intValue && dynamic_cast < const ConVar < float >* >( var ) )
+		return static_cast < float >( *intValue );
+
+	return value;
+}
+
+QString ConVarBatch::Validate( const ConVarBase* var, const Value& value )
+{
+	if ( !var->IsVariable() )
+		return QString( "%1 is a command, not a variable" ).arg( var->GetName() );
+
+	return std::visit( [ var ]( const auto& newValue ) -> QString
+	{
+		using T = std::decay_t < decltype( newValue ) >;
+
+		const auto* conVar = dynamic_cast < const ConVar < T >* >( var );
+
+		if ( !conVar )
+			return QString( "%1 does not accept %2" ).arg( var->GetName(), ToText( newValue ) );
+
+		if constexpr ( std::is_same_v < T, int > || std::is_same_v < T, float > )
+		{
+			if ( !conVar->IsInRange( newValue ) )
+				return QString( "%1 is out of range, expected between %2 - %3" ).arg( var->GetName(), ToText( conVar->GetMinValue() ), ToText( conVar->GetMaxValue() ) );
+		}
+
+		return {};
+	}, value );
+}
+
+bool ConVarBatch::Apply( ConVarBase* var, const Value& value, QString& change )
+{
+	return std::visit( [ var, &change ]( const auto& newValue )
+	{
+		using T = std::decay_t < decltype( newValue ) >;
+
+		// Checked by Validate
+		auto* conVar = static_cast < ConVar < T >* >( var );
+
+		if ( conVar->GetValue() == newValue )
+			return false;
+
+		change = QString( "%1: %2 => %3" ).arg( var->GetName(), ToText( conVar->GetValue() ), ToText( newValue ) );
+
+		// No console, the batch prints a single summary
+		conVar->SetValue( newValue, nullptr );
+		return true;
+	}, value );
+}
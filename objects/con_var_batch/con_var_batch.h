@@ -0,0 +1,68 @@
+#pragma once
+
+#include <variant>
+
+#include <QList>
+#include <QStringList>
+
+#include "console_widget_global.h"
+
+class ConsoleCore;
+class ConVarBase;
+
+// Stages ConVar value changes and applies them all or none.
+// Commit checks every staged value against the type and range of its ConVar first, nothing is changed when one is rejected
+// or when SetText rejected a value of the batch. An int staged for a float ConVar is converted.
+// A committed batch prints one summary notice instead of one per value and refreshes the consoles once.
+class CONSOLE_WIDGET_EXPORT ConVarBatch final
+{
+public:
+	// The summary and the errors are printed in console when given
+	explicit ConVarBatch( ConsoleCore* console = nullptr ) : console( console ) {}
+
+	// Staging a name again replaces its previous value, aliases resolve to their ConVar on Commit
+	void Set( const QString& name, int value ) { Stage( name, value ); }
+	void Set( const QString& name, float value ) { Stage( name, value ); }
+	void Set( const QString& name, double value ) { Stage( name, static_cast < float >( value ) ); }
+	void Set( const QString& name, bool value ) { Stage( name, value ); }
+	void Set( const QString& name, const QString& value ) { Stage( name, value ); }
+	void Set( const QString& name, const char* value ) { Stage( name, QString( value ) ); }
+
+	// Parses text according to the type of the ConVar, returns false when it is unknown or the text is not a valid value
+	bool SetText( const QString& name, const QString& text );
+
+	// Returns false and rolls back when a value is rejected, the staged values are cleared either way
+	bool Commit();
+
+	// Rolls back, the staged values and the errors are dropped and the next values start a new batch
+	void Clear();
+
+	[[nodiscard]] int GetStagedCount() const { return static_cast < int >( staged.size() ); }
+
+	// Of the values staged since the last Clear or Commit, after a Commit the ones of the committed batch
+	[[nodiscard]] QStringList GetErrors() const { return errors; }
+
+private:
+	using Value = std::variant < int, float, bool, QString >;
+
+	struct StagedValue
+	{
+		QString Name;
+		Value NewValue;
+	};
+
+	ConsoleCore* console;
+	QList < StagedValue > staged;
+	QStringList errors;
+	bool committed = false; // errors are those of the last Commit, staging a value starts a new list
+
+	void StartBatch();
+	void Stage( const QString& name, const Value& value );
+	void AddError( const QString& error );
+
+	[[nodiscard]] static Value Convert( const ConVarBase* var, const Value& value );
+	[[nodiscard]] static QString Validate( const ConVarBase* var, const Value& value );
+	[[nodiscard]] static bool Apply( ConVarBase* var, const Value& value, QString& change );
+
+	static constexpr int MaxSummaryChanges = 8;
+};
@@ -0,0 +1,166 @@
+#include "con_var_batch_test.h"
+
+#include <QTest>
+
+#include "con_var_batch.h"
+
+#include "objects/con_var/con_var.h"
+
+static bool NoCallback( ConVarBase*, const QStringList&, ConsoleCore* ) { return true; }
+
+static ConVar < int >* intVar = nullptr;
+static ConVar < float >* floatVar = nullptr;
+static ConVar < bool >* boolVar = nullptr;
+static ConVar < QString >* stringVar = nullptr;
+
+void ConVarBatchTest::initTestCase()
+{
+	intVar = ConVarManager::RegisterIntConVar( "batch_test_int", 10, "", NoCallback, true );
+	floatVar = ConVarManager::RegisterFloatConVar( "batch_test_float", 1.0f, "", NoCallback, true );
+	boolVar = ConVarManager::RegisterBoolConVar( "batch_test_bool", false, "", NoCallback, true );
+	stringVar = ConVarManager::RegisterStringConVar( "batch_test_string", "a", "", NoCallback, true );
+	ConVarManager::RegisterIntConVar( "batch_test_command", 0, "", NoCallback );
+	ConVarManager::RegisterAlias( "batch_test_int_alias", "batch_test_int" );
+
+	QVERIFY( intVar && floatVar && boolVar && stringVar );
+
+	intVar->SetMinValue( 0 );
+	intVar->SetMaxValue( 100 );
+	floatVar->SetMinValue( 0.0f );
+	floatVar->SetMaxValue( 10.0f );
+}
+
+void ConVarBatchTest::init()
+{
+	intVar->SetValue( 10, nullptr );
+	floatVar->SetValue( 1.0f, nullptr );
+	boolVar->SetValue( false, nullptr );
+	stringVar->SetValue( "a", nullptr );
+}
+
+void ConVarBatchTest::cleanupTestCase()
+{
+	for ( const char* name : { "batch_test_int", "batch_test_float", "batch_test_bool", "batch_test_string", "batch_test_command" } )
+		ConVarManager::UnregisterConVar( name );
+}
+
+void ConVarBatchTest::CommitsAll()
+{
+	ConVarBatch batch;
+	batch.Set( "batch_test_int", 42 );
+	batch.Set( "batch_test_float", 2.5 );
+	batch.Set( "batch_test_bool", true );
+	batch.Set( "batch_test_string", "b" );
+
+	QCOMPARE( batch.GetStagedCount(), 4 );
+	QVERIFY( batch.Commit() );
+	QCOMPARE( batch.GetStagedCount(), 0 );
+	QVERIFY( batch.GetErrors().isEmpty() );
+
+	QCOMPARE( intVar->GetValue(), 42 );
+	QCOMPARE( floatVar->GetValue(), 2.5f );
+	QCOMPARE( boolVar->GetValue(), true );
+	QCOMPARE( stringVar->GetValue(), QString( "b" ) );
+}
+
+void ConVarBatchTest::RejectsAll()
+{
+	ConVarBatch batch;
+	batch.Set( "batch_test_int", 50 );
+	batch.Set( "batch_test_float", 20.0f );
+	batch.Set( "batch_test_unknown", 1 );
+	batch.Set( "batch_test_string", "b" );
+
+	// Out of range and unknown, nothing is changed
+	QVERIFY( !batch.Commit() );
+	QCOMPARE( batch.GetErrors().size(), 2 );
+	QCOMPARE( batch.GetStagedCount(), 0 );
+
+	QCOMPARE( intVar->GetValue(), 10 );
+	QCOMPARE( stringVar->GetValue(), QString( "a" ) );
+}
+
+void ConVarBatchTest::WidensIntToFloat()
+{
+	ConVarBatch batch;
+	batch.Set( "batch_test_float", 3 );
+
+	QVERIFY( batch.Commit() );
+	QCOMPARE( floatVar->GetValue(), 3.0f );
+
+	// Converted first, then checked against the range
+	batch.Set( "batch_test_float", 11 );
+	QVERIFY( !batch.Commit() );
+	QCOMPARE( floatVar->GetValue(), 3.0f );
+
+	// Only int to float, not the other way
+	batch.Set( "batch_test_int", 3.0f );
+	QVERIFY( !batch.Commit() );
+	QCOMPARE( intVar->GetValue(), 10 );
+}
+
+void ConVarBatchTest::TypeMismatch()
+{
+	ConVarBatch batch;
+	batch.Set( "batch_test_bool", 1 );
+	batch.Set( "batch_test_string", true );
+	batch.Set( "batch_test_int", "42" );
+
+	QVERIFY( !batch.Commit() );
+	QCOMPARE( batch.GetErrors().size(), 3 );
+	QCOMPARE( boolVar->GetValue(), false );
+
+	// A command is not a variable
+	batch.Set( "batch_test_command", 1 );
+	QVERIFY( !batch.Commit() );
+	QCOMPARE( batch.GetErrors().size(), 1 );
+}
+
+void ConVarBatchTest::SetTextKeepsErrors()
+{
+	ConVarBatch batch;
+
+	QVERIFY( !batch.SetText( "batch_test_int", "abc" ) );
+	QVERIFY( batch.SetText( "batch_test_float", "1.5" ) );
+	QVERIFY( !batch.SetText( "batch_test_unknown", "1" ) );
+	QVERIFY( batch.SetText( "batch_test_bool", "true" ) );
+
+	// Every rejected value is still listed, and they reject the whole batch
+	QCOMPARE( batch.GetErrors().size(), 2 );
+	QCOMPARE( batch.GetStagedCount(), 2 );
+
+	QVERIFY( !batch.Commit() );
+	QCOMPARE( batch.GetErrors().size(), 2 );
+	QCOMPARE( floatVar->GetValue(), 1.0f );
+	QCOMPARE( boolVar->GetValue(), false );
+
+	// The next batch starts without them
+	QVERIFY( batch.SetText( "batch_test_float", "1.5" ) );
+	QVERIFY( batch.GetErrors().isEmpty() );
+	QVERIFY( batch.Commit() );
+	QCOMPARE( floatVar->GetValue(), 1.5f );
+}
+
+void ConVarBatchTest::ClearDropsValues()
+{
+	ConVarBatch batch;
+	batch.Set( "batch_test_int", 20 );
+	batch.SetText( "batch_test_int", "abc" );
+
+	batch.Clear();
+
+	QCOMPARE( batch.GetStagedCount(), 0 );
+	QVERIFY( batch.GetErrors().isEmpty() );
+	QVERIFY( batch.Commit() );
+	QCOMPARE( intVar->GetValue(), 10 );
+}
+
+void ConVarBatchTest::AliasLastValueWins()
+{
+	ConVarBatch batch;
+	batch.Set( "batch_test_int", 20 );
+	batch.Set( "batch_test_int_alias", 30 );
+
+	QVERIFY( batch.Commit() );
+	QCOMPARE( intVar->GetValue(), 30 );
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QObject>
+
+class ConVarBatchTest final : public QObject
+{
+	Q_OBJECT private slots:
+	void initTestCase();
+	void init();
+	void cleanupTestCase();
+
+	void CommitsAll();
+	void RejectsAll();
+	void WidensIntToFloat();
+	void TypeMismatch();
+	void SetTextKeepsErrors();
+	void ClearDropsValues();
+	void AliasLastValueWins();
+};
@@ -0,0 +1,360 @@
+#include "con_var_store.h"
+
+#include <cstring>
+
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include "objects/con_var/con_var.h"
+
+// Binary layout, little endian :
+//   char[ 4 ] magic | quint32 version | quint32 count
+//   count records of quint16 name size | UTF-8 name | quint8 eCVarType | value
+//   values are qint32 ( INT ), IEEE float bits as quint32 ( FLOAT ), quint8 ( BOOL ), quint32 size + UTF-8 ( STRING )
+
+static void AppendUInt16( QByteArray& out, const quint16 value )
+{
+	char bytes[ 2 ];
+	qToLittleEndian( value, bytes );
+	out.append( bytes, 2 );
+}
+
+static void AppendUInt32( QByteArray& out, const quint32 value )
+{
+	char bytes[ 4 ];
+	qToLittleEndian( value, bytes );
+	out.append( bytes, 4 );
+}
+
+static bool ParseBool( const QString& str, bool& ok )
+{
+	ok = true;
+
+	if ( str == "1" || str.compare( "true", Qt::CaseInsensitive ) == 0 )
+		return true;
+	if ( str == "0" || str.compare( "false", Qt::CaseInsensitive ) == 0 )
+		return false;
+
+	ok = false;
+	return false;
+}
+
+template < typename T >
+static bool ApplyValue( ConVarBase* var, const T& value )
+{
+	auto* conVar = dynamic_cast < ConVar < T >* >( var );
+
+	if ( !conVar || !conVar->IsInRange( value ) )
+		return false;
+
+	// No console, the value is set without printing the change notice
+	conVar->SetValue( value, nullptr );
+	return true;
+}
+
+bool ConVarStore::Save( const QString& path, const eConVarFileFormat format )
+{
+	QSaveFile file( path );
+
+	if ( !file.open( QIODevice::WriteOnly ) )
+		return false;
+
+	file.write( format == eConVarFileFormat::FORMAT_BINARY ? SerializeBinary() : SerializeText() );
+
+	return file.commit();
+}
+
+int ConVarStore::Load( const QString& path )
+{
+	QFile file( path );
+
+	if ( !file.open( QIODevice::ReadOnly ) )
+		return -1;
+
+	const qint64 size = file.size();
+
+	if ( size >= static_cast < qint64 >( sizeof( BinaryMagic ) ) && file.peek( sizeof( BinaryMagic ) ) == QByteArray( BinaryMagic, sizeof( BinaryMagic ) ) )
+	{
+		const uchar* data = file.map( 0, size );
+
+		if ( !data )
+			return -1;
+
+		const int applied = ApplyBinary( data, size );
+		file.unmap( const_cast < uchar* >( data ) );
+
+		ConsoleCore::UpdateConsolesCommands();
+		return applied;
+	}
+
+	const int applied = ApplyText( file.readAll() );
+
+	ConsoleCore::UpdateConsolesCommands();
+	return applied;
+}
+
+QByteArray ConVarStore::SerializeText()
+{
+	QString text = "// ConVar values, one \"name value\" per line\n";
+
+	for ( const auto& [ name, var ] : ConVarManager::GetConVars() )
+	{
+		// Aliases share the ConVar of their original name
+		if ( !var->IsVariable() || name != var->GetName() )
+			continue;
+
+		if ( const auto* conVarInt = dynamic_cast < const ConVar < int >* >( var ) )
+			text += QString( "%1 %2\n" ).arg( name ).arg( conVarInt->GetValue() );
+		else if ( const auto* conVarFloat = dynamic_cast < const ConVar < float >* >( var ) )
+			text += QString( "%1 %2\n" ).arg( name, QString::number( conVarFloat->GetValue(), 'g', 9 ) );
+		else if ( const auto* conVarBool = dynamic_cast < const ConVar < bool >* >( var ) )
+			text += QString( "%1 %2\n" ).arg( name, conVarBool->GetValue() ? "true" : "false" );
+		else if ( const auto* conVarString = dynamic_cast < const ConVar < QString >* >( var ) )
+			text += QString( "%1 %2\n" ).arg( name, Quote( conVarString->GetValue() ) );
+	}
+
+	return text.toUtf8();
+}
+
+QByteArray ConVarStore::SerializeBinary()
+{
+	QByteArray records;
+	quint32 count = 0;
+
+	for ( const auto& [ name, var ] : ConVarManager::GetConVars() )
+	{
+		if ( !var->IsVariable() || name != var->GetName() )
+			continue;
+
+		const QByteArray nameUtf8 = name.toUtf8();
+
+		AppendUInt16( records, static_cast < quint16 >( nameUtf8.size() ) );
+		records.append( nameUtf8 );
+
+		if ( const auto* conVarInt = dynamic_cast < const ConVar < int >* >( var ) )
+		{
+			records.append( static_cast < char >( eCVarType::INT ) );
+			AppendUInt32( records, static_cast < quint32 >( conVarInt->GetValue() ) );
+		}
+		else if ( const auto* conVarFloat = dynamic_cast < const ConVar < float >* >( var ) )
+		{
+			const float value = conVarFloat->GetValue();
+
+			quint32 bits;
+			std::memcpy( &bits, &value, sizeof( bits ) );
+
+			records.append( static_cast < char >( eCVarType::FLOAT ) );
+			AppendUInt32( records, bits );
+		}
+		else if ( const auto* conVarBool = dynamic_cast < const ConVar < bool >* >( var ) )
+		{
+			records.append( static_cast < char >( eCVarType::BOOL ) );
+			records.append( static_cast < char >( conVarBool->GetValue() ? 1 : 0 ) );
+		}
+		else if ( const auto* conVarString = dynamic_cast < const ConVar < QString >* >( var ) )
+		{
+			const QByteArray value = conVarString->GetValue().toUtf8();
+
+			records.append( static_cast < char >( eCVarType::STRING ) );
+			AppendUInt32( records, static_cast < quint32 >( value.size() ) );
+			records.append( value );
+		}
+
+		++count;
+	}
+
+	QByteArray data( BinaryMagic, sizeof( BinaryMagic ) );
+	AppendUInt32( data, BinaryVersion );
+	AppendUInt32( data, count );
+	data.append( records );
+
+	return data;
+}
+
+int ConVarStore::ApplyText( const QByteArray& data )
+{
+	int applied = 0;
+
+	for ( const QString& rawLine : QString::fromUtf8( data ).split( '\n' ) )
+	{
+		const QString line = rawLine.trimmed();
+
+		if ( line.isEmpty() || line.startsWith( "//" ) || line.startsWith( '#' ) )
+			continue;
+
+		const int separator = static_cast < int >( line.indexOf( ' ' ) );
+
+		if ( separator <= 0 )
+			continue;
+
+		ConVarBase* var = ConVarManager::GetConVar( line.left( separator ) );
+
+		if ( !var || !var->IsVariable() )
+			continue;
+
+		const QString value = line.mid( separator + 1 ).trimmed();
+		bool ok = false;
+
+		if ( dynamic_cast < ConVar < int >* >( var ) )
+		{
+			const int intValue = value.toInt( &ok );
+			ok = ok && ApplyValue( var, intValue );
+		}
+		else if ( dynamic_cast < ConVar < float >* >( var ) )
+		{
+			const float floatValue = value.toFloat( &ok );
+			ok = ok && ApplyValue( var, floatValue );
+		}
+		else if ( dynamic_cast < ConVar < bool >* >( var ) )
+		{
+			const bool boolValue = ParseBool( value, ok );
+			ok = ok && ApplyValue( var, boolValue );
+		}
+		else if ( dynamic_cast < ConVar < QString >* >( var ) )
+		{
+			ok = ApplyValue( var, Unquote( value ) );
+		}
+
+		if ( ok )
+			++applied;
+	}
+
+	return applied;
+}
+
+int ConVarStore::ApplyBinary( const uchar* data, const qint64 size )
+{
+	constexpr qint64 HeaderSize = sizeof( BinaryMagic ) + 8;
+
+	if ( size < HeaderSize || qFromLittleEndian < quint32 >( data + sizeof( BinaryMagic ) ) != BinaryVersion )
+		return -1;
+
+	const auto count = qFromLittleEndian < quint32 >( data + sizeof( BinaryMagic ) + 4 );
+
+	const uchar* end = data + size;
+	const uchar* it = data + HeaderSize;
+
+	int applied = 0;
+
+	for ( quint32 i = 0; i < count; ++i )
+	{
+		// Name size, name and type
+		if ( end - it < 2 )
+			break;
+
+		const auto nameSize = qFromLittleEndian < quint16 >( it );
+		it += 2;
+
+		if ( end - it < nameSize + 1 )
+			break;
+
+		const QString name = QString::fromUtf8( reinterpret_cast < const char* >( it ), nameSize );
+		it += nameSize;
+
+		const auto type = static_cast < eCVarType >( *it++ );
+
+		ConVarBase* var = ConVarManager::GetConVar( name );
+
+		// The value is always read, unknown or mismatching ConVars are skipped
+		bool ok = false;
+
+		switch ( type )
+		{
+		case eCVarType::INT:
+		{
+			if ( end - it < 4 )
+				return applied;
+
+			const auto value = static_cast < int >( qFromLittleEndian < quint32 >( it ) );
+			it += 4;
+
+			ok = var && var->IsVariable() && ApplyValue( var, value );
+			break;
+		}
+		case eCVarType::FLOAT:
+		{
+			if ( end - it < 4 )
+				return applied;
+
+			const auto bits = qFromLittleEndian < quint32 >( it );
+			it += 4;
+
+			float value;
+			std::memcpy( &value, &bits, sizeof( value ) );
+
+			ok = var && var->IsVariable() && ApplyValue( var, value );
+			break;
+		}
+		case eCVarType::BOOL:
+		{
+			if ( end - it < 1 )
+				return applied;
+
+			const bool value = *it++ != 0;
+
+			ok = var && var->IsVariable() && ApplyValue( var, value );
+			break;
+		}
+		case eCVarType::STRING:
+		{
+			if ( end - it < 4 )
+				return applied;
+
+			const auto valueSize = qFromLittleEndian < quint32 >( it );
+			it += 4;
+
+			if ( static_cast < quint64 >( end - it ) < valueSize )
+				return applied;
+
+			const QString value = QString::fromUtf8( reinterpret_cast < const char* >( it ), static_cast < int >( valueSize ) );
+			it += valueSize;
+
+			ok = var && var->IsVariable() && ApplyValue( var, value );
+			break;
+		}
+		default:
+			// Unknown value layout, the rest of the file can not be read
+			return applied;
+		}
+
+		if ( ok )
+			++applied;
+	}
+
+	return applied;
+}
+
+QString ConVarStore::Quote( const QString& str )
+{
+	QString quoted = str;
+	quoted.replace( '\\', "\\\\" ).replace( '"', "\\\"" ).replace( '\n', "\\n" );
+
+	return '"' + quoted + '"';
+}
+
+QString ConVarStore::Unquote( const QString& str )
+{
+	if ( str.size() < 2 || !str.startsWith( '"' ) || !str.endsWith( '"' ) )
+		return str;
+
+	QString result;
+	result.reserve( str.size() - 2 );
+
+	for ( int i = 1; i < str.size() - 1; ++i )
+	{
+		QChar c = str[ i ];
+
+		if ( c == '\\' && i + 1 < str.size() - 1 )
+		{
+			c = str[ ++i ];
+
+			if ( c == 'n' )
+				c = '\n';
+		}
+
+		result.append( c );
+	}
+
+	return result;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QString>
+
+#include "console_widget_global.h"
+
+enum class eConVarFileFormat
+{
+	FORMAT_TEXT, // One "name value" per line, strings are quoted
+	FORMAT_BINARY // Compact snapshot, memory-mapped and applied in one pass when loaded
+};
+
+// Saves and restores the values of the variable ConVars.
+// Loading never prints, values are applied directly and the consoles are refreshed once at the end.
+class CONSOLE_WIDGET_EXPORT ConVarStore final
+{
+public:
+	static bool Save( const QString& path, eConVarFileFormat format = eConVarFileFormat::FORMAT_BINARY );
+
+	// The format is detected from the file content, returns the number of values applied or -1 when the file can not be read
+	static int Load( const QString& path );
+
+private:
+	static QByteArray SerializeText();
+	static QByteArray SerializeBinary();
+
+	static int ApplyText( const QByteArray& data );
+	static int ApplyBinary( const uchar* data, qint64 size );
+
+	static QString Quote( const QString& str );
+	static QString Unquote( const QString& str );
+
+	static constexpr char BinaryMagic[ 4 ] = { 'C', 'V', 'A', 'R' };
+	static constexpr quint32 BinaryVersion = 1;
+};
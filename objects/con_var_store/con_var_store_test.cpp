@@ -0,0 +1,175 @@
+#include "con_var_store_test.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "con_var_store.h"
+
+#include "objects/con_var/con_var.h"
+
+static bool NoCallback( ConVarBase*, const QStringList&, ConsoleCore* ) { return true; }
+
+static ConVar < int >* intVar = nullptr;
+static ConVar < float >* floatVar = nullptr;
+static ConVar < bool >* boolVar = nullptr;
+static ConVar < QString >* stringVar = nullptr;
+
+static const QString TrickyString = U8( "say \"hi\" \\ back\nnext line, héllo ✓ " );
+
+// Values every round trip starts from, then overwritten before loading
+static void SetSavedValues()
+{
+	intVar->SetValue( -42, nullptr );
+	floatVar->SetValue( 0.1f, nullptr );
+	boolVar->SetValue( true, nullptr );
+	stringVar->SetValue( TrickyString, nullptr );
+}
+
+static void SetOtherValues()
+{
+	intVar->SetValue( 7, nullptr );
+	floatVar->SetValue( 3.0f, nullptr );
+	boolVar->SetValue( false, nullptr );
+	stringVar->SetValue( "other", nullptr );
+}
+
+static void CompareSavedValues()
+{
+	QCOMPARE( intVar->GetValue(), -42 );
+	QCOMPARE( floatVar->GetValue(), 0.1f );
+	QCOMPARE( boolVar->GetValue(), true );
+	QCOMPARE( stringVar->GetValue(), TrickyString );
+}
+
+void ConVarStoreTest::initTestCase()
+{
+	intVar = ConVarManager::RegisterIntConVar( "store_test_int", 0, "", NoCallback, true );
+	floatVar = ConVarManager::RegisterFloatConVar( "store_test_float", 0.0f, "", NoCallback, true );
+	boolVar = ConVarManager::RegisterBoolConVar( "store_test_bool", false, "", NoCallback, true );
+	stringVar = ConVarManager::RegisterStringConVar( "store_test_string", "", "", NoCallback, true );
+	ConVarManager::RegisterIntConVar( "store_test_command", 0, "", NoCallback );
+	ConVarManager::RegisterAlias( "store_test_int_alias", "store_test_int" );
+
+	QVERIFY( intVar && floatVar && boolVar && stringVar );
+
+	intVar->SetMinValue( -100 );
+	intVar->SetMaxValue( 100 );
+}
+
+void ConVarStoreTest::init() { SetSavedValues(); }
+
+void ConVarStoreTest::cleanupTestCase()
+{
+	for ( const char* name : { "store_test_int", "store_test_float", "store_test_bool", "store_test_string", "store_test_command" } )
+		ConVarManager::UnregisterConVar( name );
+}
+
+void ConVarStoreTest::TextRoundTrip()
+{
+	QTemporaryDir dir;
+	QVERIFY( dir.isValid() );
+
+	const QString path = dir.filePath( "convars.cfg" );
+	QVERIFY( ConVarStore::Save( path, eConVarFileFormat::FORMAT_TEXT ) );
+
+	// Commands and aliases are not saved
+	QFile file( path );
+	QVERIFY( file.open( QIODevice::ReadOnly ) );
+
+	const QString text = QString::fromUtf8( file.readAll() );
+	QVERIFY( !text.contains( "store_test_command" ) );
+	QVERIFY( !text.contains( "store_test_int_alias" ) );
+
+	SetOtherValues();
+
+	QCOMPARE( ConVarStore::Load( path ), 4 );
+	CompareSavedValues();
+}
+
+void ConVarStoreTest::BinaryRoundTrip()
+{
+	QTemporaryDir dir;
+	QVERIFY( dir.isValid() );
+
+	const QString path = dir.filePath( "convars.bin" );
+	QVERIFY( ConVarStore::Save( path, eConVarFileFormat::FORMAT_BINARY ) );
+
+	QFile file( path );
+	QVERIFY( file.open( QIODevice::ReadOnly ) );
+	QVERIFY( file.peek( 4 ) == "CVAR" );
+	file.close();
+
+	SetOtherValues();
+
+	QCOMPARE( ConVarStore::Load( path ), 4 );
+	CompareSavedValues();
+}
+
+void ConVarStoreTest::InvalidTextValues()
+{
+	QTemporaryDir dir;
+	QVERIFY( dir.isValid() );
+
+	const QString path = dir.filePath( "convars.cfg" );
+
+	QFile file( path );
+	QVERIFY( file.open( QIODevice::WriteOnly ) );
+	file.write( "// comment\n"
+		"# comment\n"
+		"store_test_int 1000\n" // Out of range
+		"store_test_float abc\n"
+		"store_test_bool maybe\n"
+		"store_test_unknown 1\n"
+		"store_test_command 1\n"
+		"\n"
+		"store_test_int_alias 12\r\n"
+		"store_test_string plain\n" );
+	file.close();
+
+	// Only the alias and the unquoted string are applied
+	QCOMPARE( ConVarStore::Load( path ), 2 );
+	QCOMPARE( intVar->GetValue(), 12 );
+	QCOMPARE( floatVar->GetValue(), 0.1f );
+	QCOMPARE( boolVar->GetValue(), true );
+	QCOMPARE( stringVar->GetValue(), QString( "plain" ) );
+}
+
+void ConVarStoreTest::TruncatedBinary()
+{
+	QTemporaryDir dir;
+	QVERIFY( dir.isValid() );
+
+	const QString path = dir.filePath( "convars.bin" );
+	QVERIFY( ConVarStore::Save( path, eConVarFileFormat::FORMAT_BINARY ) );
+
+	QFile file( path );
+	QVERIFY( file.open( QIODevice::ReadOnly ) );
+	const QByteArray data = file.readAll();
+	file.close();
+
+	// Every cut is read up to the last complete record, a cut header is rejected
+	for ( qsizetype size = 4; size < data.size(); ++size )
+	{
+		QVERIFY( file.open( QIODevice::WriteOnly | QIODevice::Truncate ) );
+		file.write( data.left( size ) );
+		file.close();
+
+		SetOtherValues();
+
+		const int applied = ConVarStore::Load( path );
+		QVERIFY( applied < 4 );
+
+		if ( size < 12 )
+			QCOMPARE( applied, -1 );
+	}
+}
+
+void ConVarStoreTest::MissingFile()
+{
+	QTemporaryDir dir;
+	QVERIFY( dir.isValid() );
+
+	QCOMPARE( ConVarStore::Load( dir.filePath( "missing.cfg" ) ), -1 );
+	CompareSavedValues();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <QObject>
+
+class ConVarStoreTest final : public QObject
+{
+	Q_OBJECT private slots:
+	void initTestCase();
+	void init();
+	void cleanupTestCase();
+
+	void TextRoundTrip();
+	void BinaryRoundTrip();
+	void InvalidTextValues();
+	void TruncatedBinary();
+	void MissingFile();
+};
@@ -0,0 +1,167 @@
+#include "console_core.h"
+
+#include <QDateTime>
+
+#include "objects/con_var/con_var.h"
+
+ConsoleCore::ConsoleCore( QObject* parent ) : QObject( parent )
+{
+	cores.push_back( this );
+
+	scrollback.SetBudget( memoryBudget - GetHotBudget() );
+}
+
+ConsoleCore::~ConsoleCore() { cores.removeOne( this ); }
+
+void ConsoleCore::AddLine( const QString& line, const ePrintType type, const int channel )
+{
+	// Dropped before anything is formatted
+	if ( LogChannels::IsMuted( channel ) )
+		return;
+
+	const int lineChannel = LogChannels::IsValid( channel ) ? channel : LogChannels::DefaultChannel;
+	const QString message = lineChannel == LogChannels::DefaultChannel ? line : QString( "[%1] %2" ).arg( LogChannels::GetName( lineChannel ), line );
+
+	QString str;
+	const QDateTime currentDateTime = QDateTime::currentDateTime();
+	QString timestamp = currentDateTime.toString( "[yyyy-MM-dd hh:mm:ss]" );
+
+	switch ( type )
+	{
+	case ePrintType::PRINT_INFO:
+		str = QString( "%1 [INFO]     %2" ).arg( timestamp, message );
+		break;
+	case ePrintType::PRINT_NOTICE:
+		str = QString( "%1 [NOTICE]   %2" ).arg( timestamp, message );
+		break;
+	case ePrintType::PRINT_WARNING:
+		str = QString( "%1 [WARNING]  %2" ).arg( timestamp, message );
+		break;
+	case ePrintType::PRINT_ERROR:
+		str = QString( "%1 [ERROR]    %2" ).arg( timestamp, message );
+		break;
+	case ePrintType::PRINT_SUCCESS:
+		str = QString( "%1 [SUCCESS]  %2" ).arg( timestamp, message );
+		break;
+	}
+
+	LineData data;
+	data.Text = str;
+	data.Type = type;
+	data.Time = currentDateTime;
+	data.Channel = lineChannel;
+
+	channelLines[ lineChannel ].push_back( firstLineId + static_cast < quint64 >( lines.size() ) );
+	lines.push_back( data );
+	lineBytes += Scrollback::GetLineBytes( data );
+	emit LineAdded( data );
+
+	TrimLines();
+}
+
+void ConsoleCore::AddLines( const QList < QueuedLine >& batch )
+{
+	emit BatchStarted();
+
+	for ( const auto& [ text, type, channel ] : batch )
+		AddLine( text, type, channel );
+
+	emit BatchFinished();
+}
+
+void ConsoleCore::Clear()
+{
+	// Ids are never reused, pending work on the old lines can not map onto the next ones
+	firstLineId += static_cast < quint64 >( lines.size() );
+	lines.clear();
+	lineBytes = 0;
+	scrollback.Clear();
+
+	for ( QList < quint64 >& channelIds : channelLines )
+		channelIds.clear();
+
+	emit Cleared();
+}
+
+const LineData* ConsoleCore::FindLine( const quint64 lineId ) const
+{
+	if ( lineId < firstLineId )
+		return scrollback.FindLine( lineId );
+
+	return lineId < GetEndLineId() ? &lines[ static_cast < int >( lineId - firstLineId ) ] : nullptr;
+}
+
+void ConsoleCore::SetMemoryBudget( const qint64 bytes )
+{
+	memoryBudget = bytes;
+
+	scrollback.SetBudget( memoryBudget - GetHotBudget() );
+	TrimLines();
+}
+
+void ConsoleCore::TrimLines()
+{
+	// The newest line always stays, even when it is larger than the budget
+	while ( lineBytes > GetHotBudget() && lines.size() > 1 )
+	{
+		const LineData& line = lines.front();
+
+		channelLines[ line.Channel ].pop_front();
+		lineBytes -= Scrollback::GetLineBytes( line );
+		scrollback.Append( line, firstLineId );
+
+		lines.pop_front();
+		++firstLineId;
+		emit FirstLineRemoved();
+	}
+}
+
+bool ConsoleCore::SetHistoryFile( const QString& path )
+{
+	if ( path.isEmpty() )
+	{
+		history.Close();
+		return true;
+	}
+
+	return history.Open( path );
+}
+
+void ConsoleCore::ExecuteCommand( const QString& command, const bool addToHistory )
+{
+	if ( command.isEmpty() )
+		return;
+
+	if ( addToHistory )
+		history.Add( command );
+
+	const QStringList args = command.split( ' ', Qt::SkipEmptyParts );
+
+	if ( args.isEmpty() )
+		return;
+
+	// command is the first argument ( args[ 0 ] )
+	if ( ConVarBase* conVar = ConVarManager::GetConVar( args[ 0 ] ) )
+	{
+		const int argCount = conVar->GetArgumentCount();
+
+		if ( args.size() < argCount + 1 )
+			ConVarManager::PrintInvalidArgument( this, conVar, args[ 0 ] );
+		else
+			conVar->Callback( conVar, args, this );
+	}
+	else
+	{
+		Print( ePrintType::PRINT_ERROR ) << QString( "Unknown command: %1" ).arg( args[ 0 ] );
+		Print( ePrintType::PRINT_INFO ) << QString( "Type 'help' for a list of available commands" );
+	}
+}
+
+void ConsoleCore::UpdateConsolesCommands()
+{
+	for ( ConsoleCore* core : cores )
+	{
+		if ( core )
+			emit core->CommandsChanged();
+	}
+}
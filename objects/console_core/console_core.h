@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+
+#include <QObject>
+#include <QStringList>
+
+#include "console_widget_global.h"
+#include "utils/const.h"
+
+#include "objects/command_history/command_history.h"
+#include "objects/line_data/line_data.h"
+#include "objects/log_channels/log_channels.h"
+#include "objects/scrollback/scrollback.h"
+#include "objects/line_queue/line_queue.h"
+#include "objects/console_printer/console_printer.h"
+
+// UI-free part of a console : line store, command history and command dispatch.
+// Only depends on QtCore, headless builds use it directly and ConsoleWidget is a view on top of it.
+class CONSOLE_WIDGET_EXPORT ConsoleCore final : public QObject
+{
+	Q_OBJECT public:
+	explicit ConsoleCore( QObject* parent = nullptr );
+	~ConsoleCore() override;
+
+	ConsolePrinter Print( const ePrintType type = ePrintType::PRINT_INFO ) { return ConsolePrinter( this, type ); }
+	ConsolePrinter Print( const int channel, const ePrintType type = ePrintType::PRINT_INFO ) { return ConsolePrinter( this, channel, type ); }
+
+	void AddLine( const QString& line, ePrintType type = ePrintType::PRINT_INFO, int channel = LogChannels::DefaultChannel );
+	void AddLines( const QList < QueuedLine >& batch );
+	void Clear();
+
+	// Commands typed in this console go to its history, the ones received from elsewhere do not
+	void ExecuteCommand( const QString& command, bool addToHistory = true );
+
+	[[nodiscard]] const QList < LineData >& GetLines() const { return lines; }
+	[[nodiscard]] quint64 GetFirstLineId() const { return firstLineId; }
+	[[nodiscard]] quint64 GetEndLineId() const { return firstLineId + static_cast < quint64 >( lines.size() ); }
+	[[nodiscard]] const Scrollback& GetScrollback() const { return scrollback; }
+
+	// Id of the oldest line kept, in the scrollback or in the lines
+	[[nodiscard]] quint64 GetOldestLineId() const { return scrollback.IsEmpty() ? firstLineId : scrollback.GetFirstLineId(); }
+
+	// Line with this id, a line of the scrollback is decompressed on demand. Null when it is not kept anymore,
+	// valid until the next call or until the lines change
+	[[nodiscard]] const LineData* FindLine( quint64 lineId ) const;
+
+	// Memory kept for the lines, 1 / HotBudgetDivisor for the visible lines and the rest for the compressed scrollback
+	void SetMemoryBudget( qint64 bytes );
+	[[nodiscard]] qint64 GetMemoryBudget() const { return memoryBudget; }
+
+	[[nodiscard]] const QList < quint64 >& GetChannelLines( const int channel ) const { return channelLines[ LogChannels::IsValid( channel ) ? channel : LogChannels::DefaultChannel ]; }
+	[[nodiscard]] CommandHistory& GetHistory() { return history; }
+	[[nodiscard]] const CommandHistory& GetHistory() const { return history; }
+
+	// Loads the history from path and appends every new command to it, an empty path closes the file
+	bool SetHistoryFile( const QString& path );
+	[[nodiscard]] QString GetHistoryFile() const { return history.GetPath(); }
+
+	static QList < ConsoleCore* > GetCores() { return cores; }
+
+	static GlobalConsolePrinter PrintGlobal( const ePrintType type = ePrintType::PRINT_INFO ) { return GlobalConsolePrinter( type ); }
+	static GlobalConsolePrinter PrintGlobal( const int channel, const ePrintType type = ePrintType::PRINT_INFO ) { return GlobalConsolePrinter( channel, type ); }
+
+	static void UpdateConsolesCommands();
+
+signals:
+	void LineAdded( const LineData& line );
+	void FirstLineRemoved();
+	void Cleared();
+	void BatchStarted();
+	void BatchFinished();
+	void CommandsChanged();
+
+	// The scrollback command asks the views to show the lines containing text
+	void SearchRequested( const QString& text );
+
+private:
+	QList < LineData > lines;
+	quint64 firstLineId = 0; // Id of lines.front(), ids keep increasing when lines are removed
+
+	std::array < QList < quint64 >, LogChannels::MaxChannels > channelLines; // Ids of the lines of each channel, in order
+
+	qint64 lineBytes = 0;
+	qint64 memoryBudget = DefaultMemoryBudget;
+	Scrollback scrollback;
+
+	void TrimLines();
+	[[nodiscard]] qint64 GetHotBudget() const { return memoryBudget / HotBudgetDivisor; }
+
+	CommandHistory history;
+
+	inline static QList < ConsoleCore* > cores;
+
+	static constexpr qint64 DefaultMemoryBudget = 16 * 1024 * 1024;
+	static constexpr int HotBudgetDivisor = 16;
+};
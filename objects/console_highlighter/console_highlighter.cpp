@@ -0,0 +1,102 @@
+#include "console_highlighter.h"
+
+#include <algorithm>
+
+#include <QTextBlock>
+
+#include "objects/line_data/line_data.h"
+
+ConsoleHighlighter::ConsoleHighlighter( QPlainTextEdit* edit, ColorProvider provider ) : QSyntaxHighlighter( edit->document() ), textEdit( edit ), colorProvider( std::move( provider ) )
+{
+	// Scrolling and resizing repaint the viewport, restyle what became visible
+	connect( textEdit, &QPlainTextEdit::updateRequest, this, &ConsoleHighlighter::RestyleVisibleBlocks );
+}
+
+void ConsoleHighlighter::Restyle()
+{
+	++generation;
+	RestyleVisibleBlocks();
+}
+
+void ConsoleHighlighter::RestyleBlocks( const QList < int >& blockNumbers )
+{
+	const QTextDocument* document = textEdit->document();
+
+	for ( const int blockNumber : blockNumbers )
+	{
+		// Blocks never styled are already stale
+		if ( auto* style = static_cast < StyleData* >( document->findBlockByNumber( blockNumber ).userData() ) )
+			style->Generation = StaleGeneration;
+	}
+
+	RestyleVisibleBlocks();
+}
+
+void ConsoleHighlighter::highlightBlock( const QString& text )
+{
+	const QTextCharFormat& format = GetFormat( colorProvider( currentBlock().blockNumber() ) );
+
+	// Long lines end with their expander, hits are only looked for in the displayed prefix
+	const int length = static_cast < int >( std::min < qsizetype >( text.size(), LineData::LongLineLength ) );
+
+	setFormat( 0, length, format );
+
+	if ( text.size() > length )
+	{
+		QTextCharFormat expanderFormat = format;
+		expanderFormat.setFontUnderline( true );
+		setFormat( length, static_cast < int >( text.size() ) - length, expanderFormat );
+	}
+
+	if ( !query.IsEmpty() )
+	{
+		QTextCharFormat hitFormat = format;
+		hitFormat.setBackground( filterHitColor );
+
+		for ( const auto& [ start, size ] : query.GetHits( text.left( length ) ) )
+			setFormat( start, size, hitFormat );
+	}
+
+	if ( !search.IsEmpty() )
+	{
+		QTextCharFormat hitFormat = format;
+		hitFormat.setBackground( findHitColor );
+
+		const auto* data = reinterpret_cast < const char16_t* >( text.utf16() );
+		const qsizetype size = search.GetLength();
+
+		for ( qsizetype position = search.IndexIn( data, length ); position >= 0; position = search.IndexIn( data, length, position + size ) )
+			setFormat( static_cast < int >( position ), static_cast < int >( size ), hitFormat );
+	}
+
+	if ( auto* style = static_cast < StyleData* >( currentBlockUserData() ) )
+		style->Generation = generation;
+	else
+		setCurrentBlockUserData( new StyleData( generation ) );
+}
+
+void ConsoleHighlighter::RestyleVisibleBlocks()
+{
+	const QTextBlock first = textEdit->cursorForPosition( QPoint( 0, 0 ) ).block();
+	const int last = textEdit->cursorForPosition( QPoint( 0, textEdit->viewport()->height() ) ).blockNumber();
+
+	for ( QTextBlock block = first; block.isValid() && block.blockNumber() <= last; block = block.next() )
+	{
+		if ( const auto* style = static_cast < const StyleData* >( block.userData() ); !style || style->Generation != generation )
+			rehighlightBlock( block );
+	}
+}
+
+const QTextCharFormat& ConsoleHighlighter::GetFormat( const QColor& color )
+{
+	auto it = formats.find( color.rgba() );
+
+	if ( it == formats.end() )
+	{
+		QTextCharFormat format;
+		format.setForeground( color );
+		it = formats.insert( color.rgba(), format );
+	}
+
+	return it.value();
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <functional>
+
+#include <QHash>
+#include <QPlainTextEdit>
+#include <QSyntaxHighlighter>
+
+#include "objects/line_query/line_query.h"
+#include "objects/log_channels/log_channels.h"
+#include "objects/text_search/text_search.h"
+
+// Styles the console lines while they are laid out instead of storing a char format in every line.
+// Lines sharing a color share one format, filter and find hits are highlighted inside the lines.
+// Restyling only rehighlights the visible blocks, the other ones are restyled when scrolled into view.
+class ConsoleHighlighter final : public QSyntaxHighlighter
+{
+public:
+	// Returns the color of the line shown by a block
+	using ColorProvider = std::function < QColor( int blockNumber ) >;
+
+	ConsoleHighlighter( QPlainTextEdit* edit, ColorProvider provider );
+
+	void SetQuery( const LineQuery& lineQuery ) { query = lineQuery; }
+	void SetSearch( const TextSearch& textSearch ) { search = textSearch; }
+
+	// Lines of a hidden channel are grayed out, a channel filter only shows the lines of its channels
+	void SetHiddenChannels( const quint64 mask ) { hiddenChannels = mask; }
+	void SetChannelFilter( const quint64 mask ) { channelFilter = mask; }
+	[[nodiscard]] quint64 GetHiddenChannels() const { return hiddenChannels; }
+	[[nodiscard]] quint64 GetChannelFilter() const { return channelFilter; }
+	[[nodiscard]] bool IsChannelShown( const int channel ) const { return ( channelFilter & ~hiddenChannels & LogChannels::ChannelBit( channel ) ) != 0; }
+
+	// Every block becomes stale, the visible ones are rehighlighted right away
+	void Restyle();
+
+	// Only these blocks become stale
+	void RestyleBlocks( const QList < int >& blockNumbers );
+
+	static constexpr quint64 AllChannels = ~quint64( 0 );
+
+	static void SetFilterHitColor( const QColor& color ) { filterHitColor = color; }
+	static void SetFindHitColor( const QColor& color ) { findHitColor = color; }
+
+protected:
+	void highlightBlock( const QString& text ) override;
+
+private:
+	class StyleData final : public QTextBlockUserData
+	{
+	public:
+		explicit StyleData( const int styleGeneration ) : Generation( styleGeneration ) {}
+
+		int Generation;
+	};
+
+	QPlainTextEdit* textEdit;
+	ColorProvider colorProvider;
+
+	LineQuery query;
+	TextSearch search;
+
+	quint64 hiddenChannels = 0;
+	quint64 channelFilter = AllChannels;
+
+	// Blocks styled with an older generation are stale. Kept in the block user data, the block state would cascade to the next blocks
+	int generation = 0;
+
+	QHash < QRgb, QTextCharFormat > formats;
+
+	static constexpr int StaleGeneration = -1;
+
+	void RestyleVisibleBlocks();
+	[[nodiscard]] const QTextCharFormat& GetFormat( const QColor& color );
+
+	inline static QColor filterHitColor = { "#3A3F4B" }; // Gray dark
+	inline static QColor findHitColor = { "#FFF3A0" }; // Yellow light
+};
@@ -1,17 +1,20 @@
 #include "console_printer.h"
-#include "console_widget.h"
+#include "objects/console_core/console_core.h"
 
 ConsolePrinter::~ConsolePrinter()
 {
-	if ( console )
-		console->AddLine( QString::fromStdString( stream.str() ), type );
+	if ( console && !muted )
+		console->AddLine( QString::fromStdString( stream.str() ), type, channel );
 }
 
 GlobalConsolePrinter::~GlobalConsolePrinter()
 {
-	for ( ConsoleWidget* console : ConsoleWidget::GetConsoles() )
+	if ( muted )
+		return;
+
+	for ( ConsoleCore* console : ConsoleCore::GetCores() )
 	{
 		if ( console )
-			console->AddLine( QString::fromStdString( stream.str() ), type );
+			console->AddLine( QString::fromStdString( stream.str() ), type, channel );
 	}
 }
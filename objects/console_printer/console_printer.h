@@ -5,26 +5,32 @@
 #include <QString>
 
 #include "utils/const.h"
+#include "objects/log_channels/log_channels.h"
 
-class ConsoleWidget;
+class ConsoleCore;
 
 class ConsolePrinter
 {
 public:
 	explicit ConsolePrinter( const ePrintType printType = ePrintType::PRINT_INFO ) : type( printType ) {}
-	explicit ConsolePrinter( ConsoleWidget* consolePtr, const ePrintType printType = ePrintType::PRINT_INFO ) : type( printType ), console( consolePtr ) {}
+	explicit ConsolePrinter( ConsoleCore* consolePtr, const ePrintType printType = ePrintType::PRINT_INFO ) : type( printType ), console( consolePtr ) {}
+	ConsolePrinter( ConsoleCore* consolePtr, const int printChannel, const ePrintType printType ) : type( printType ), console( consolePtr ), channel( printChannel ), muted( LogChannels::IsMuted( printChannel ) ) {}
 	virtual ~ConsolePrinter();
 
 	template < typename T >
 	ConsolePrinter& operator<<( const T& value )
 	{
-		stream << value << ' ';
+		if ( !muted )
+			stream << value << ' ';
+
 		return *this;
 	}
 
 	ConsolePrinter& operator<<( const QString& value )
 	{
-		stream << value.toStdString() << ' ';
+		if ( !muted )
+			stream << value.toStdString() << ' ';
+
 		return *this;
 	}
 
@@ -33,7 +39,9 @@ public:
 
 protected:
 	ePrintType type;
-	ConsoleWidget* console = nullptr;
+	ConsoleCore* console = nullptr;
+	int channel = LogChannels::DefaultChannel;
+	bool muted = false; // Nothing is formatted for a muted channel
 	std::ostringstream stream;
 };
 
@@ -41,5 +49,6 @@ class GlobalConsolePrinter final : public ConsolePrinter
 {
 public:
 	explicit GlobalConsolePrinter( const ePrintType printType = ePrintType::PRINT_INFO ) : ConsolePrinter( printType ) {}
+	GlobalConsolePrinter( const int printChannel, const ePrintType printType ) : ConsolePrinter( nullptr, printChannel, printType ) {}
 	~GlobalConsolePrinter() override;
 };
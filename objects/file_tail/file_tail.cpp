@@ -0,0 +1,320 @@
+#include "file_tail.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+#include "objects/console_core/console_core.h"
+#include "objects/log_channels/log_channels.h"
+
+#if defined( Q_OS_WIN )
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <io.h>
+# include <windows.h>
+#else
+# include <sys/stat.h>
+#endif
+
+FileTail::FileTail( const QString& filePath, const bool mapLevels, ConsoleCore* console ) : QObject( console ), path( QFileInfo( filePath ).absoluteFilePath() ), mapLevels( mapLevels ), channel( LogChannels::Register( QFileInfo( filePath ).fileName() ) ), queue( new LineQueue( this ) ), context( new QObject )
+{
+	connect( queue, &LineQueue::LinesReady, console, &ConsoleCore::AddLines );
+
+	context->moveToThread( &thread );
+	thread.start();
+
+	QMetaObject::invokeMethod( context, [ this ] { Start(); }, Qt::QueuedConnection );
+}
+
+FileTail::~FileTail()
+{
+	// Deferred deletions are processed when the thread finishes
+	context->deleteLater();
+
+	thread.quit();
+	thread.wait();
+}
+
+ePrintType FileTail::DetectLevel( const QString& line )
+{
+	const QStringView head = QStringView( line ).left( LevelScanLength );
+
+	for ( qsizetype i = 0; i < head.size(); )
+	{
+		if ( !head[ i ].isLetter() )
+		{
+			++i;
+			continue;
+		}
+
+		const qsizetype start = i;
+		while ( i < head.size() && head[ i ].isLetter() )
+			++i;
+
+		const QStringView word = head.mid( start, i - start );
+
+		const auto is = [ &word ]( const char* keyword ) { return word.compare( QLatin1String( keyword ), Qt::CaseInsensitive ) == 0; };
+
+		if ( is( "error" ) || is( "err" ) || is( "fatal" ) || is( "critical" ) || is( "crit" ) || is( "severe" ) )
+			return ePrintType::PRINT_ERROR;
+		if ( is( "warning" ) || is( "warn" ) )
+			return ePrintType::PRINT_WARNING;
+		if ( is( "notice" ) )
+			return ePrintType::PRINT_NOTICE;
+		if ( is( "success" ) )
+			return ePrintType::PRINT_SUCCESS;
+		if ( is( "info" ) || is( "debug" ) || is( "trace" ) || is( "verbose" ) )
+			return ePrintType::PRINT_INFO;
+	}
+
+	return ePrintType::PRINT_INFO;
+}
+
+void FileTail::Start()
+{
+	// Watching the directory too catches the file being created again after a rotation
+	auto* watcher = new QFileSystemWatcher( context );
+	watcher->addPath( QFileInfo( path ).absolutePath() );
+
+	auto* pollTimer = new QTimer( context );
+	pollTimer->start( PollInterval );
+
+	connect( watcher, &QFileSystemWatcher::fileChanged, context, [ this ] { Update(); } );
+	connect( watcher, &QFileSystemWatcher::directoryChanged, context, [ this ] { Update(); } );
+	connect( pollTimer, &QTimer::timeout, context, [ this, watcher ]
+	{
+		// A renamed or deleted file is no longer watched
+		if ( !watcher->files().contains( path ) && QFileInfo::exists( path ) )
+			watcher->addPath( path );
+
+		Update();
+	} );
+
+	// Lines without a channel of their own are printed on the default one
+	if ( channel == LogChannels::InvalidChannel )
+		PushNotice( QString( "tail: no log channel left for %1, its lines go to the default channel" ).arg( path ), ePrintType::PRINT_WARNING );
+
+	if ( !Open() )
+	{
+		PushNotice( QString( "tail: waiting for %1" ).arg( path ), ePrintType::PRINT_WARNING );
+		return;
+	}
+
+	watcher->addPath( path );
+	PushNotice( QString( "tail: following %1" ).arg( path ), ePrintType::PRINT_NOTICE );
+
+	ReadInitialLines();
+}
+
+void FileTail::Update()
+{
+	if ( !file.isOpen() )
+	{
+		if ( Open() )
+		{
+			PushNotice( QString( "tail: following %1" ).arg( path ), ePrintType::PRINT_NOTICE );
+			ReadAvailable();
+		}
+
+		return;
+	}
+
+	// Paused, the rotation is handled once the old file was read to its end
+	if ( !ReadAvailable() )
+		return;
+
+	// Rotated, the old file was read to its end above
+	if ( QFile current( path ); current.open( QIODevice::ReadOnly ) && GetIdentity( current ) != identity )
+	{
+		current.close();
+
+		// The writer may have added lines to the old file since it was read
+		if ( !ReadAvailable() )
+			return;
+
+		file.close();
+
+		if ( Open() )
+		{
+			PushNotice( QString( "tail: %1 was rotated" ).arg( path ), ePrintType::PRINT_NOTICE );
+			ReadAvailable();
+		}
+	}
+}
+
+bool FileTail::Open()
+{
+	file.setFileName( path );
+
+	if ( !file.open( QIODevice::ReadOnly ) )
+		return false;
+
+	identity = GetIdentity( file );
+	offset = 0;
+
+	// Whatever was left of the previous file ends there
+	if ( !partial.isEmpty() )
+	{
+		QList < QueuedLine > lines;
+		AddParsedLine( partial.constData(), partial.size(), lines );
+		queue->Push( lines );
+		partial.clear();
+	}
+
+	return true;
+}
+
+void FileTail::ReadInitialLines()
+{
+	// Like tail, start with the last lines of the file
+	const qint64 size = file.size();
+	const qint64 start = std::max < qint64 >( 0, size - InitialReadSize );
+
+	file.seek( start );
+	const QByteArray data = file.read( size - start );
+
+	QList < QueuedLine > lines;
+	ParseChunk( data.constData(), data.size(), lines );
+
+	// The first line may have been cut
+	if ( start > 0 && !lines.isEmpty() )
+		lines.pop_front();
+
+	if ( lines.size() > InitialLineCount )
+		lines = lines.mid( lines.size() - InitialLineCount );
+
+	queue->Push( lines );
+	offset = start + data.size();
+}
+
+bool FileTail::ReadAvailable()
+{
+	const qint64 size = file.size();
+
+	if ( size < offset )
+	{
+		PushNotice( QString( "tail: %1 was truncated" ).arg( path ), ePrintType::PRINT_NOTICE );
+
+		offset = 0;
+		partial.clear();
+	}
+
+	// One batch per window, mapped windows avoid copying the data before it is split
+	while ( offset < size )
+	{
+		if ( IsQueueFull() )
+			return false;
+
+		const qint64 length = std::min( size - offset, MapWindowSize );
+		qint64 consumed = length;
+		QList < QueuedLine > lines;
+
+		if ( uchar* data = file.map( offset, length ) )
+		{
+			ParseChunk( reinterpret_cast < const char* >( data ), length, lines );
+			file.unmap( data );
+		}
+		else
+		{
+			// Some file systems can not be mapped
+			file.seek( offset );
+			const QByteArray data = file.read( length );
+
+			if ( data.isEmpty() )
+				break;
+
+			ParseChunk( data.constData(), data.size(), lines );
+			consumed = data.size();
+		}
+
+		offset += consumed;
+		queue->Push( lines );
+	}
+
+	return true;
+}
+
+bool FileTail::IsQueueFull()
+{
+	if ( queue->GetPendingCount() < MaxQueuedLines )
+		return false;
+
+	// Read the rest soon after the console caught up, instead of at the next poll
+	if ( !resumeQueued )
+	{
+		resumeQueued = true;
+
+		QTimer::singleShot( ResumeInterval, context, [ this ]
+		{
+			resumeQueued = false;
+			Update();
+		} );
+	}
+
+	return true;
+}
+
+void FileTail::ParseChunk( const char* data, const qint64 size, QList < QueuedLine >& lines )
+{
+	qint64 start = 0;
+
+	for ( const void* newline = std::memchr( data, '\n', size ); newline; newline = std::memchr( data + start, '\n', size - start ) )
+	{
+		const qint64 end = static_cast < const char* >( newline ) - data;
+
+		if ( partial.isEmpty() )
+		{
+			AddParsedLine( data + start, end - start, lines );
+		}
+		else
+		{
+			partial.append( data + start, static_cast < int >( end - start ) );
+			AddParsedLine( partial.constData(), partial.size(), lines );
+			partial.clear();
+		}
+
+		start = end + 1;
+	}
+
+	partial.append( data + start, static_cast < int >( size - start ) );
+
+	// A file without line feeds still shows up
+	if ( partial.size() >= MaxPartialSize )
+	{
+		AddParsedLine( partial.constData(), partial.size(), lines );
+		partial.clear();
+	}
+}
+
+void FileTail::AddParsedLine( const char* data, qint64 size, QList < QueuedLine >& lines ) const
+{
+	if ( size > 0 && data[ size - 1 ] == '\r' )
+		--size;
+
+	const QString text = QString::fromUtf8( data, static_cast < int >( size ) );
+
+	lines.push_back( { text, mapLevels ? DetectLevel( text ) : ePrintType::PRINT_INFO, channel } );
+}
+
+std::pair < quint64, quint64 > FileTail::GetIdentity( const QFile& openFile )
+{
+#if defined( Q_OS_WIN )
+	BY_HANDLE_FILE_INFORMATION info;
+
+	if ( !GetFileInformationByHandle( reinterpret_cast < HANDLE >( _get_osfhandle( openFile.handle() ) ), &info ) )
+		return {};
+
+	return { info.dwVolumeSerialNumber, static_cast < quint64 >( info.nFileIndexHigh ) << 32 | info.nFileIndexLow };
+#else
+	struct stat info;
+
+	if ( fstat( openFile.handle(), &info ) != 0 )
+		return {};
+
+	return { static_cast < quint64 >( info.st_dev ), static_cast < quint64 >( info.st_ino ) };
+#endif
+}
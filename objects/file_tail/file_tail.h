@@ -0,0 +1,66 @@
+#pragma once
+
+#include <utility>
+
+#include <QFile>
+#include <QThread>
+
+#include "utils/const.h"
+
+#include "objects/line_queue/line_queue.h"
+
+class ConsoleCore;
+
+// Follows a file written by another process and adds its new lines to a console, like tail -f.
+// The file is watched and read through memory-mapped windows on a dedicated thread, lines reach the console in batches.
+// Reading pauses while the console has MaxQueuedLines waiting, a writer faster than the console is read at the console's pace.
+// Rotation ( the path now names another file ) and truncation are detected, the rest of a rotated file is read before switching.
+class FileTail final : public QObject
+{
+	Q_OBJECT public:
+	// Owned by the console, lines go to a log channel named after the file
+	FileTail( const QString& filePath, bool mapLevels, ConsoleCore* console );
+	~FileTail() override;
+
+	[[nodiscard]] QString GetPath() const { return path; }
+
+	// Level keyword ( error, warning, notice... ) found at the start of a line, PRINT_INFO otherwise
+	[[nodiscard]] static ePrintType DetectLevel( const QString& line );
+
+private:
+	QString path;
+	bool mapLevels;
+	int channel;
+
+	LineQueue* queue;
+	QThread thread;
+	QObject* context; // Lives in the thread, parent of the watcher and the poll timer
+
+	// Only used from the thread
+	QFile file;
+	std::pair < quint64, quint64 > identity = {};
+	qint64 offset = 0;
+	QByteArray partial; // Incomplete last line
+	bool resumeQueued = false;
+
+	void Start();
+	void Update();
+	bool Open();
+	bool ReadAvailable();
+	bool IsQueueFull();
+	void ReadInitialLines();
+	void ParseChunk( const char* data, qint64 size, QList < QueuedLine >& lines );
+	void AddParsedLine( const char* data, qint64 size, QList < QueuedLine >& lines ) const;
+	void PushNotice( const QString& text, ePrintType type ) const { queue->Push( { { text, type, channel } } ); }
+
+	[[nodiscard]] static std::pair < quint64, quint64 > GetIdentity( const QFile& openFile );
+
+	static constexpr qint64 MapWindowSize = 1024 * 1024; // The queue is checked between windows, it goes at most one window past MaxQueuedLines
+	static constexpr qint64 MaxPartialSize = 16 * 1024 * 1024;
+	static constexpr qint64 InitialReadSize = 64 * 1024;
+	static constexpr int InitialLineCount = 10;
+	static constexpr int PollInterval = 500; // ms, in case a change notification is missed
+	static constexpr int MaxQueuedLines = 100000;
+	static constexpr int ResumeInterval = 20; // ms, waiting for the console to take queued lines
+	static constexpr int LevelScanLength = 64;
+};
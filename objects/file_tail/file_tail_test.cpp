@@ -0,0 +1,180 @@
+#include "file_tail_test.h"
+
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "file_tail.h"
+
+#include "objects/console_core/console_core.h"
+
+// Text of a line as written in the file, after the timestamp, level and channel added by the console
+static QString GetText( const LineData& line )
+{
+	const QString tag = QString( "[%1] " ).arg( LogChannels::GetName( line.Channel ) );
+
+	return line.Text.mid( line.Text.indexOf( tag ) + tag.size() );
+}
+
+static QStringList GetTexts( const ConsoleCore& core )
+{
+	QStringList texts;
+
+	for ( const LineData& line : core.GetLines() )
+		texts.push_back( GetText( line ) );
+
+	return texts;
+}
+
+static bool Write( const QString& path, const QByteArray& data, const QIODevice::OpenMode mode = QIODevice::Append )
+{
+	QFile file( path );
+	return file.open( QIODevice::WriteOnly | mode ) && file.write( data ) == data.size();
+}
+
+void FileTailTest::DetectLevel()
+{
+	QCOMPARE( FileTail::DetectLevel( "2024-01-02 [ERROR] disk full" ), ePrintType::PRINT_ERROR );
+	QCOMPARE( FileTail::DetectLevel( "warn: slow frame" ), ePrintType::PRINT_WARNING );
+	QCOMPARE( FileTail::DetectLevel( "Notice - restarted" ), ePrintType::PRINT_NOTICE );
+	QCOMPARE( FileTail::DetectLevel( "[debug] error count 0" ), ePrintType::PRINT_INFO );
+
+	// Whole words only
+	QCOMPARE( FileTail::DetectLevel( "terror and warnings" ), ePrintType::PRINT_INFO );
+}
+
+void FileTailTest::InitialLines()
+{
+	const QTemporaryDir dir;
+	const QString path = dir.filePath( "initial.log" );
+
+	QByteArray data;
+	for ( int i = 0; i < 20; ++i )
+		data += QByteArray( "line " ) + QByteArray::number( i ) + "\r\n";
+
+	QVERIFY( Write( path, data ) );
+
+	ConsoleCore core;
+	new FileTail( path, false, &core );
+
+	// Like tail, only the last lines, without the carriage returns
+	QTRY_VERIFY( GetTexts( core ).contains( "line 19" ) );
+	QVERIFY( GetTexts( core ).contains( "line 10" ) );
+	QVERIFY( !GetTexts( core ).contains( "line 9" ) );
+}
+
+void FileTailTest::AppendedLines()
+{
+	const QTemporaryDir dir;
+	const QString path = dir.filePath( "appended.log" );
+
+	QVERIFY( Write( path, "first\n" ) );
+
+	ConsoleCore core;
+	new FileTail( path, true, &core );
+
+	QTRY_VERIFY( GetTexts( core ).contains( "first" ) );
+
+	// The incomplete line waits for its line feed
+	QVERIFY( Write( path, "error: second\nthi" ) );
+	QTRY_VERIFY( GetTexts( core ).contains( "error: second" ) );
+	QVERIFY( !GetTexts( core ).contains( "thi" ) );
+
+	QVERIFY( Write( path, "rd\n" ) );
+	QTRY_VERIFY( GetTexts( core ).contains( "third" ) );
+
+	const LineData& line = core.GetLines()[ static_cast < int >( GetTexts( core ).indexOf( "error: second" ) ) ];
+	QCOMPARE( line.Type, ePrintType::PRINT_ERROR );
+	QCOMPARE( LogChannels::GetName( line.Channel ), QString( "appended.log" ) );
+}
+
+void FileTailTest::Truncation()
+{
+	const QTemporaryDir dir;
+	const QString path = dir.filePath( "truncated.log" );
+
+	QVERIFY( Write( path, "a rather long line before the truncation\n" ) );
+
+	ConsoleCore core;
+	new FileTail( path, false, &core );
+
+	QTRY_VERIFY( GetTexts( core ).contains( "a rather long line before the truncation" ) );
+
+	QVERIFY( Write( path, "after\n", QIODevice::Truncate ) );
+
+	QTRY_VERIFY( GetTexts( core ).contains( "after" ) );
+	QVERIFY( GetTexts( core ).contains( QString( "tail: %1 was truncated" ).arg( path ) ) );
+}
+
+void FileTailTest::Rotation()
+{
+#if defined( Q_OS_WIN )
+	QSKIP( "QFile does not share delete access, a file open for reading can not be renamed" );
+#endif
+
+	const QTemporaryDir dir;
+	const QString path = dir.filePath( "rotated.log" );
+	const QString rotatedPath = path + ".1";
+
+	QVERIFY( Write( path, "before\n" ) );
+
+	ConsoleCore core;
+	new FileTail( path, false, &core );
+
+	QTRY_VERIFY( GetTexts( core ).contains( "before" ) );
+
+	// The writer keeps writing to the old file for a while, then the path names a new one
+	QVERIFY( QFile::rename( path, rotatedPath ) );
+	QVERIFY( Write( rotatedPath, "late\n" ) );
+	QVERIFY( Write( path, "new file\n" ) );
+
+	QTRY_VERIFY( GetTexts( core ).contains( "new file" ) );
+
+	const QStringList texts = GetTexts( core );
+	const qsizetype rotated = texts.indexOf( QString( "tail: %1 was rotated" ).arg( path ) );
+
+	QVERIFY( rotated >= 0 );
+	QVERIFY( texts.indexOf( "late" ) >= 0 && texts.indexOf( "late" ) < rotated );
+	QVERIFY( texts.indexOf( "new file" ) > rotated );
+}
+
+void FileTailTest::FastWriter()
+{
+	const QTemporaryDir dir;
+	const QString path = dir.filePath( "fast.log" );
+
+	QVERIFY( Write( path, "" ) );
+
+	ConsoleCore core;
+	core.SetMemoryBudget( 256 * 1024 * 1024 );
+	new FileTail( path, false, &core );
+
+	QTRY_VERIFY( GetTexts( core ).contains( QString( "tail: following %1" ).arg( path ) ) );
+
+	// More lines than the queue takes at once, every one of them arrives in order
+	constexpr int LineCount = 300000;
+	QByteArray data;
+
+	for ( int i = 0; i < LineCount; ++i )
+		data += QByteArray( "fast " ) + QByteArray::number( i ) + '\n';
+
+	QVERIFY( Write( path, data ) );
+
+	QTRY_VERIFY_WITH_TIMEOUT( GetText( core.GetLines().back() ) == QString( "fast %1" ).arg( LineCount - 1 ), 30000 );
+
+	const quint64 first = core.GetOldestLineId();
+	quint64 next = 0;
+	bool ordered = true;
+
+	for ( quint64 lineId = first; lineId < core.GetEndLineId(); ++lineId )
+	{
+		const LineData* line = core.FindLine( lineId );
+
+		if ( !line || !GetText( *line ).startsWith( "fast " ) )
+			continue;
+
+		ordered &= GetText( *line ) == QString( "fast %1" ).arg( next++ );
+	}
+
+	QVERIFY( ordered );
+	QCOMPARE( next, quint64( LineCount ) );
+}
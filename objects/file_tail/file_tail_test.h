@@ -0,0 +1,14 @@
+#pragma once
+
+#include <QObject>
+
+class FileTailTest final : public QObject
+{
+	Q_OBJECT private slots:
+	void DetectLevel();
+	void InitialLines();
+	void AppendedLines();
+	void Truncation();
+	void Rotation();
+	void FastWriter();
+};
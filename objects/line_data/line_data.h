@@ -1,10 +1,16 @@
 #pragma once
 
-#include <QColor>
+#include <QDateTime>
 
 struct LineData
 {
 	QString Text;
-	QColor Color;
 	ePrintType Type;
+	QDateTime Time;
+	int Channel = 0; // LogChannels id
+
+	// Longer lines are rendered truncated, filters and searches only look at this prefix unless asked for a full search
+	static constexpr int LongLineLength = 4096;
+
+	[[nodiscard]] bool IsLong() const { return Text.size() > LongLineLength; }
 };
@@ -0,0 +1,83 @@
+#include "line_filter.h"
+
+#include <algorithm>
+
+#include "utils/defines.h"
+
+LineFilter::LineFilter( QObject* parent ) : QObject( parent )
+{
+	// A single worker, queries are serialized and stale ones bail out early
+	pool.setMaxThreadCount( 1 );
+}
+
+LineFilter::~LineFilter()
+{
+	Cancel();
+	pool.clear();
+	pool.waitForDone();
+}
+
+quint64 LineFilter::Run( const LineQuery& query, const QList < LineData >& snapshot, const quint64 firstLineId, const Scrollback& scrollback )
+{
+	const quint64 runGeneration = ++generation;
+
+	// Drop queued queries that did not start yet
+	pool.clear();
+
+	pool.start( [ this, query, snapshot, firstLineId, scrollback, runGeneration ]
+	{
+		LineFilterResult result;
+		result.Generation = runGeneration;
+		result.FirstLineId = scrollback.IsEmpty() ? firstLineId : std::min( scrollback.GetFirstLineId(), firstLineId );
+
+#if defined( QT_6 )
+		const int size = static_cast < int >( snapshot.size() );
+#elif defined( QT_5 )
+		const int size = snapshot.size();
+#endif
+
+		const int offset = static_cast < int >( firstLineId - result.FirstLineId );
+		result.Matches.resize( offset + size );
+
+		// Cold lines first, decompressed block by block
+		int scanned = 0;
+		bool cancelled = false;
+
+		scrollback.ForEachLine( [ & ]( const LineData& line, const quint64 lineId )
+		{
+			if ( ++scanned % CancelCheckInterval == 0 && generation != runGeneration )
+			{
+				cancelled = true;
+				return false;
+			}
+
+			if ( lineId < firstLineId && query.Matches( line ) )
+				result.Matches.setBit( static_cast < int >( lineId - result.FirstLineId ) );
+
+			return true;
+		} );
+
+		if ( cancelled )
+			return;
+
+		for ( int i = 0; i < size; ++i )
+		{
+			if ( i % CancelCheckInterval == 0 && generation != runGeneration )
+				return;
+
+			if ( query.Matches( snapshot[ i ] ) )
+				result.Matches.setBit( offset + i );
+		}
+
+		if ( generation != runGeneration )
+			return;
+
+		QMetaObject::invokeMethod( this, [ this, result ]
+		{
+			if ( result.Generation == generation )
+				emit Finished( result );
+		}, Qt::QueuedConnection );
+	} );
+
+	return runGeneration;
+}
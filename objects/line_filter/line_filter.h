@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+
+#include <QBitArray>
+#include <QObject>
+#include <QThreadPool>
+
+#include "objects/line_query/line_query.h"
+#include "objects/scrollback/scrollback.h"
+
+struct LineFilterResult
+{
+	quint64 Generation = 0;
+	quint64 FirstLineId = 0; // Id of the first line of the snapshot, the oldest line of the scrollback when there is one
+	QBitArray Matches;
+};
+
+// Runs a LineQuery over a snapshot of the console lines and of the scrollback before them on a worker thread.
+// Starting a new query cancels the one in flight, only the latest result is ever delivered.
+class LineFilter final : public QObject
+{
+	Q_OBJECT public:
+	explicit LineFilter( QObject* parent = nullptr );
+	~LineFilter() override;
+
+	quint64 Run( const LineQuery& query, const QList < LineData >& snapshot, quint64 firstLineId, const Scrollback& scrollback = {} );
+	void Cancel() { ++generation; }
+
+	[[nodiscard]] quint64 GetGeneration() const { return generation; }
+
+signals:
+	// Always emitted on the thread owning the filter
+	void Finished( const LineFilterResult& result );
+
+private:
+	QThreadPool pool;
+	std::atomic < quint64 > generation = 0;
+
+	static constexpr int CancelCheckInterval = 4096;
+};
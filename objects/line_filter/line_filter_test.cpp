@@ -0,0 +1,75 @@
+#include "line_filter_test.h"
+
+#include <QTest>
+
+#include "line_filter.h"
+
+static constexpr int LargeSnapshotSize = 200000;
+
+static QList < LineData > MakeSnapshot( const int size )
+{
+	QList < LineData > lines;
+	lines.reserve( size );
+
+	for ( int i = 0; i < size; ++i )
+		lines.push_back( { QString( "line %1 %2" ).arg( i ).arg( i % 3 == 0 ? "alpha" : "beta" ), ePrintType::PRINT_INFO, QDateTime::currentDateTime(), 0 } );
+
+	return lines;
+}
+
+void LineFilterTest::MatchesByLine()
+{
+	LineFilter filter;
+	QList < LineFilterResult > results;
+	connect( &filter, &LineFilter::Finished, this, [ &results ]( const LineFilterResult& result ) { results.push_back( result ); } );
+
+	const QList < LineData > snapshot = MakeSnapshot( 100 );
+	const quint64 generation = filter.Run( LineQuery::Parse( "alpha" ), snapshot, 1000 );
+
+	QTRY_COMPARE( results.size(), 1 );
+
+	const LineFilterResult& result = results.front();
+	QCOMPARE( result.Generation, generation );
+	QCOMPARE( result.FirstLineId, quint64( 1000 ) );
+	QCOMPARE( result.Matches.size(), 100 );
+
+	for ( int i = 0; i < 100; ++i )
+		QCOMPARE( result.Matches.testBit( i ), i % 3 == 0 );
+}
+
+void LineFilterTest::StaleResultIsDropped()
+{
+	LineFilter filter;
+	QList < LineFilterResult > results;
+	connect( &filter, &LineFilter::Finished, this, [ &results ]( const LineFilterResult& result ) { results.push_back( result ); } );
+
+	const QList < LineData > snapshot = MakeSnapshot( LargeSnapshotSize );
+
+	const quint64 stale = filter.Run( LineQuery::Parse( "alpha" ), snapshot, 0 );
+	const quint64 latest = filter.Run( LineQuery::Parse( "beta" ), snapshot, 0 );
+
+	QVERIFY( latest > stale );
+	QTRY_COMPARE( results.size(), 1 );
+
+	// Give a stale result that was already queued the time to come through
+	QTest::qWait( 100 );
+
+	QCOMPARE( results.size(), 1 );
+	QCOMPARE( results.front().Generation, latest );
+	QVERIFY( !results.front().Matches.testBit( 0 ) );
+	QVERIFY( results.front().Matches.testBit( 1 ) );
+}
+
+void LineFilterTest::CancelDropsResult()
+{
+	LineFilter filter;
+	int finishedCount = 0;
+	connect( &filter, &LineFilter::Finished, this, [ &finishedCount ] { ++finishedCount; } );
+
+	// Small enough to be done before Cancel, the result is dropped when delivered
+	filter.Run( LineQuery::Parse( "alpha" ), MakeSnapshot( 10 ), 0 );
+	filter.Cancel();
+
+	QTest::qWait( 100 );
+	QCOMPARE( finishedCount, 0 );
+}
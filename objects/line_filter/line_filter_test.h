@@ -0,0 +1,11 @@
+#pragma once
+
+#include <QObject>
+
+class LineFilterTest final : public QObject
+{
+	Q_OBJECT private slots:
+	void MatchesByLine();
+	void StaleResultIsDropped();
+	void CancelDropsResult();
+};
@@ -0,0 +1,87 @@
+#include "line_finder.h"
+
+#include "utils/defines.h"
+
+LineFinder::LineFinder( QObject* parent ) : QObject( parent )
+{
+	// A single worker, searches are serialized and stale ones bail out early
+	pool.setMaxThreadCount( 1 );
+}
+
+LineFinder::~LineFinder()
+{
+	Cancel();
+	pool.clear();
+	pool.waitForDone();
+}
+
+quint64 LineFinder::Run( const TextSearch& search, const bool fullLines, const QList < LineData >& snapshot, const quint64 firstLineId, const Scrollback& scrollback )
+{
+	const quint64 runGeneration = ++generation;
+
+	// Drop queued searches that did not start yet
+	pool.clear();
+
+	pool.start( [ this, search, fullLines, snapshot, firstLineId, scrollback, runGeneration ]
+	{
+		LineFinderResult result;
+		result.Generation = runGeneration;
+		result.EndLineId = firstLineId + static_cast < quint64 >( snapshot.size() );
+
+		// Cold lines first, decompressed block by block
+		int scanned = 0;
+		bool cancelled = false;
+
+		scrollback.ForEachLine( [ & ]( const LineData& line, const quint64 lineId )
+		{
+			if ( ++scanned % CancelCheckInterval == 0 && generation != runGeneration )
+			{
+				cancelled = true;
+				return false;
+			}
+
+			if ( lineId < firstLineId )
+				FindInLine( search, fullLines, line, lineId, result.Matches );
+
+			return true;
+		} );
+
+		if ( cancelled )
+			return;
+
+#if defined( QT_6 )
+		const int size = static_cast < int >( snapshot.size() );
+#elif defined( QT_5 )
+		const int size = snapshot.size();
+#endif
+
+		for ( int i = 0; i < size; ++i )
+		{
+			if ( i % CancelCheckInterval == 0 && generation != runGeneration )
+				return;
+
+			FindInLine( search, fullLines, snapshot[ i ], firstLineId + i, result.Matches );
+		}
+
+		if ( generation != runGeneration )
+			return;
+
+		QMetaObject::invokeMethod( this, [ this, result ]
+		{
+			if ( result.Generation == generation )
+				emit Finished( result );
+		}, Qt::QueuedConnection );
+	} );
+
+	return runGeneration;
+}
+
+void LineFinder::FindInLine( const TextSearch& search, const bool fullLines, const LineData& line, const quint64 lineId, QList < LineFindMatch >& matches )
+{
+	const qsizetype length = search.GetLength();
+	const auto* text = reinterpret_cast < const char16_t* >( line.Text.utf16() );
+	const qsizetype size = line.IsLong() && !fullLines ? LineData::LongLineLength : line.Text.size();
+
+	for ( qsizetype position = search.IndexIn( text, size ); position >= 0; position = search.IndexIn( text, size, position + length ) )
+		matches.push_back( { lineId, static_cast < int >( position ) } );
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+
+#include <QObject>
+#include <QThreadPool>
+
+#include "objects/line_data/line_data.h"
+#include "objects/scrollback/scrollback.h"
+#include "objects/text_search/text_search.h"
+
+struct LineFindMatch
+{
+	quint64 LineId;
+	int Position;
+};
+
+struct LineFinderResult
+{
+	quint64 Generation = 0;
+	quint64 EndLineId = 0; // Lines from this id on were added after the snapshot and were not searched
+	QList < LineFindMatch > Matches; // Sorted by line id then position
+};
+
+// Looks for a TextSearch in a snapshot of the console lines and of the scrollback before them on a worker thread.
+// Like LineFilter, starting a new search cancels the one in flight and only the latest result is delivered.
+class LineFinder final : public QObject
+{
+	Q_OBJECT public:
+	explicit LineFinder( QObject* parent = nullptr );
+	~LineFinder() override;
+
+	quint64 Run( const TextSearch& search, bool fullLines, const QList < LineData >& snapshot, quint64 firstLineId, const Scrollback& scrollback = {} );
+	void Cancel() { ++generation; }
+
+	[[nodiscard]] quint64 GetGeneration() const { return generation; }
+
+	// Appends the matches of a line, long lines stop at their displayed prefix unless fullLines is set
+	static void FindInLine( const TextSearch& search, bool fullLines, const LineData& line, quint64 lineId, QList < LineFindMatch >& matches );
+
+signals:
+	// Always emitted on the thread owning the finder
+	void Finished( const LineFinderResult& result );
+
+private:
+	QThreadPool pool;
+	std::atomic < quint64 > generation = 0;
+
+	static constexpr int CancelCheckInterval = 4096;
+};
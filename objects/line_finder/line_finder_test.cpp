@@ -0,0 +1,110 @@
+#include "line_finder_test.h"
+
+#include <QTest>
+
+#include "line_finder.h"
+
+static constexpr int LargeSnapshotSize = 200000;
+
+static LineData MakeLine( const int index )
+{
+	return { QString( "line %1 %2" ).arg( index ).arg( index % 3 == 0 ? "alpha alpha" : "beta" ), ePrintType::PRINT_INFO, QDateTime::currentDateTime(), 0 };
+}
+
+static QList < LineData > MakeSnapshot( const int size )
+{
+	QList < LineData > lines;
+	lines.reserve( size );
+
+	for ( int i = 0; i < size; ++i )
+		lines.push_back( MakeLine( i ) );
+
+	return lines;
+}
+
+void LineFinderTest::FindsMatches()
+{
+	LineFinder finder;
+	QList < LineFinderResult > results;
+	connect( &finder, &LineFinder::Finished, this, [ &results ]( const LineFinderResult& result ) { results.push_back( result ); } );
+
+	QList < LineData > snapshot = MakeSnapshot( 100 );
+	snapshot[ 1 ].Text = QString( LineData::LongLineLength, 'x' ) + "ALPHA";
+
+	const quint64 generation = finder.Run( TextSearch( "Alpha" ), false, snapshot, 1000 );
+
+	QTRY_COMPARE( results.size(), 1 );
+
+	const LineFinderResult& result = results.front();
+	QCOMPARE( result.Generation, generation );
+	QCOMPARE( result.EndLineId, quint64( 1100 ) );
+
+	// Two matches on every third line, none past the displayed prefix of the long line
+	QCOMPARE( result.Matches.size(), 2 * 34 );
+	QCOMPARE( result.Matches[ 0 ].LineId, quint64( 1000 ) );
+	QCOMPARE( result.Matches[ 0 ].Position, 7 );
+	QCOMPARE( result.Matches[ 1 ].Position, 13 );
+	QCOMPARE( result.Matches[ 2 ].LineId, quint64( 1003 ) );
+
+	// Unless full lines are searched
+	finder.Run( TextSearch( "Alpha" ), true, snapshot, 1000 );
+
+	QTRY_COMPARE( results.size(), 2 );
+	QCOMPARE( results[ 1 ].Matches.size(), 2 * 34 + 1 );
+	QCOMPARE( results[ 1 ].Matches[ 2 ].LineId, quint64( 1001 ) );
+	QCOMPARE( results[ 1 ].Matches[ 2 ].Position, LineData::LongLineLength );
+}
+
+void LineFinderTest::SearchesScrollback()
+{
+	LineFinder finder;
+	QList < LineFinderResult > results;
+	connect( &finder, &LineFinder::Finished, this, [ &results ]( const LineFinderResult& result ) { results.push_back( result ); } );
+
+	Scrollback scrollback;
+	scrollback.SetBudget( 1024 * 1024 );
+
+	for ( int i = 0; i < 50; ++i )
+		scrollback.Append( MakeLine( i ), i );
+
+	const QList < LineData > snapshot = MakeSnapshot( 10 );
+	finder.Run( TextSearch( "alpha" ), false, snapshot, 50, scrollback );
+
+	QTRY_COMPARE( results.size(), 1 );
+
+	const QList < LineFindMatch >& matches = results.front().Matches;
+	QCOMPARE( matches.size(), 2 * ( 17 + 4 ) );
+	QCOMPARE( matches.front().LineId, quint64( 0 ) );
+	QCOMPARE( matches[ 2 * 17 ].LineId, quint64( 50 ) );
+
+	for ( int i = 1; i < matches.size(); ++i )
+		QVERIFY( matches[ i - 1 ].LineId <= matches[ i ].LineId );
+}
+
+void LineFinderTest::StaleResultIsDropped()
+{
+	LineFinder finder;
+	QList < LineFinderResult > results;
+	connect( &finder, &LineFinder::Finished, this, [ &results ]( const LineFinderResult& result ) { results.push_back( result ); } );
+
+	const QList < LineData > snapshot = MakeSnapshot( LargeSnapshotSize );
+
+	const quint64 stale = finder.Run( TextSearch( "alpha" ), false, snapshot, 0 );
+	const quint64 latest = finder.Run( TextSearch( "line 7" ), false, snapshot, 0 );
+
+	QVERIFY( latest > stale );
+	QTRY_COMPARE( results.size(), 1 );
+
+	QTest::qWait( 100 );
+
+	QCOMPARE( results.size(), 1 );
+	QCOMPARE( results.front().Generation, latest );
+	QCOMPARE( results.front().Matches.front().LineId, quint64( 7 ) );
+
+	// Cancelled, a finished search is not delivered
+	finder.Run( TextSearch( "beta" ), false, MakeSnapshot( 10 ), 0 );
+	finder.Cancel();
+
+	QTest::qWait( 100 );
+	QCOMPARE( results.size(), 1 );
+}
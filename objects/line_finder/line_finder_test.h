@@ -0,0 +1,11 @@
+#pragma once
+
+#include <QObject>
+
+class LineFinderTest final : public QObject
+{
+	Q_OBJECT private slots:
+	void FindsMatches();
+	void SearchesScrollback();
+	void StaleResultIsDropped();
+};
@@ -0,0 +1,180 @@
+#include "line_query.h"
+
+#include "objects/log_channels/log_channels.h"
+
+LineQuery LineQuery::Parse( const QString& query )
+{
+	LineQuery result;
+
+	for ( const QString& token : query.split( ',' ) )
+	{
+		QString term = token.trimmed();
+
+		if ( term.startsWith( "type:", Qt::CaseInsensitive ) )
+		{
+			const QString typeName = term.mid( 5 ).trimmed().toLower();
+
+			if ( typeName == "info" )
+				result.typeMask |= TypeBit( ePrintType::PRINT_INFO );
+			else if ( typeName == "notice" )
+				result.typeMask |= TypeBit( ePrintType::PRINT_NOTICE );
+			else if ( typeName == "warning" )
+				result.typeMask |= TypeBit( ePrintType::PRINT_WARNING );
+			else if ( typeName == "success" )
+				result.typeMask |= TypeBit( ePrintType::PRINT_SUCCESS );
+			else if ( typeName == "error" )
+				result.typeMask |= TypeBit( ePrintType::PRINT_ERROR );
+
+			continue;
+		}
+
+		if ( term.startsWith( "channel:", Qt::CaseInsensitive ) )
+		{
+			if ( const int channel = LogChannels::Find( term.mid( 8 ).trimmed() ); channel != -1 )
+				result.channelMask |= LogChannels::ChannelBit( channel );
+
+			continue;
+		}
+
+		if ( term.compare( "scan:full", Qt::CaseInsensitive ) == 0 )
+		{
+			result.fullLines = true;
+			continue;
+		}
+
+		if ( term.startsWith( "after:", Qt::CaseInsensitive ) )
+		{
+			result.from = ParseTime( term.mid( 6 ).trimmed() );
+			continue;
+		}
+
+		if ( term.startsWith( "before:", Qt::CaseInsensitive ) )
+		{
+			result.to = ParseTime( term.mid( 7 ).trimmed() );
+			continue;
+		}
+
+		bool exclude = false;
+		if ( term.startsWith( '-' ) || term.startsWith( '!' ) )
+		{
+			exclude = true;
+			term = term.mid( 1 );
+		}
+
+		Term parsed;
+
+		if ( term.size() > 2 && term.startsWith( '/' ) && term.endsWith( '/' ) )
+		{
+			parsed.Regex = QRegularExpression( term.mid( 1, term.size() - 2 ), QRegularExpression::CaseInsensitiveOption );
+
+			// Silently ignore terms that are still being typed
+			if ( !parsed.Regex.isValid() )
+				continue;
+
+			parsed.Regex.optimize();
+			parsed.IsRegex = true;
+		}
+		else
+		{
+			if ( term.size() < MinTermLength )
+				continue;
+
+			parsed.Text = term;
+		}
+
+		if ( exclude )
+			result.excludes.push_back( parsed );
+		else
+			result.includes.push_back( parsed );
+	}
+
+	return result;
+}
+
+bool LineQuery::Matches( const LineData& line ) const
+{
+	if ( typeMask != 0 && !( typeMask & TypeBit( line.Type ) ) )
+		return false;
+
+	if ( channelMask != 0 && !( channelMask & LogChannels::ChannelBit( line.Channel ) ) )
+		return false;
+
+	if ( from.isValid() && line.Time < from )
+		return false;
+
+	if ( to.isValid() && line.Time > to )
+		return false;
+
+	for ( const Term& term : excludes )
+	{
+		if ( TermMatches( term, line.Text ) )
+			return false;
+	}
+
+	if ( includes.isEmpty() )
+		return true;
+
+	for ( const Term& term : includes )
+	{
+		if ( TermMatches( term, line.Text ) )
+			return true;
+	}
+
+	return false;
+}
+
+QList < QPair < int, int > > LineQuery::GetHits( const QString& text ) const
+{
+	QList < QPair < int, int > > hits;
+
+	for ( const Term& term : includes )
+	{
+		if ( term.IsRegex )
+		{
+			for ( QRegularExpressionMatchIterator it = term.Regex.globalMatch( text ); it.hasNext(); )
+			{
+				const QRegularExpressionMatch match = it.next();
+
+				if ( match.capturedLength() > 0 )
+					hits.push_back( { static_cast < int >( match.capturedStart() ), static_cast < int >( match.capturedLength() ) } );
+			}
+		}
+		else
+		{
+			const int length = static_cast < int >( term.Text.size() );
+
+			for ( int position = static_cast < int >( text.indexOf( term.Text, 0, Qt::CaseInsensitive ) ); position != -1; position = static_cast < int >( text.indexOf( term.Text, position + length, Qt::CaseInsensitive ) ) )
+				hits.push_back( { position, length } );
+		}
+	}
+
+	return hits;
+}
+
+bool LineQuery::TermMatches( const Term& term, const QString& text ) const
+{
+	// Long lines stop at the rendered prefix
+	const bool bounded = !fullLines && text.size() > LineData::LongLineLength;
+
+	if ( term.IsRegex )
+		return term.Regex.match( bounded ? text.left( LineData::LongLineLength ) : text ).hasMatch();
+
+	return QStringView( text ).left( bounded ? LineData::LongLineLength : text.size() ).contains( term.Text, Qt::CaseInsensitive );
+}
+
+QDateTime LineQuery::ParseTime( const QString& str )
+{
+	for ( const QString& format : QStringList { "yyyy-MM-dd hh:mm:ss", "yyyy-MM-dd hh:mm", "yyyy-MM-dd" } )
+	{
+		if ( const QDateTime dateTime = QDateTime::fromString( str, format ); dateTime.isValid() )
+			return dateTime;
+	}
+
+	for ( const QString& format : QStringList { "hh:mm:ss", "hh:mm" } )
+	{
+		if ( const QTime time = QTime::fromString( str, format ); time.isValid() )
+			return { QDate::currentDate(), time };
+	}
+
+	return {};
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QDateTime>
+#include <QList>
+#include <QRegularExpression>
+
+#include "utils/const.h"
+#include "objects/line_data/line_data.h"
+
+// Filter query typed in the console filter bar.
+// Comma separated terms, a line is kept when it passes every criteria:
+//   text        case-insensitive substring ( at least 2 characters )
+//   /regex/     case-insensitive regular expression
+//   -term       exclude lines matching the term ( also works with /regex/ )
+//   type:name   keep only this print type ( info, notice, warning, success, error ), repeatable
+//   channel:name keep only this log channel, repeatable
+//   after:time  keep lines printed after time ( hh:mm, hh:mm:ss or yyyy-MM-dd hh:mm:ss )
+//   before:time keep lines printed before time
+//   scan:full   look at the whole of long lines, only their first LineData::LongLineLength characters otherwise
+class LineQuery
+{
+public:
+	LineQuery() = default;
+
+	static LineQuery Parse( const QString& query );
+
+	[[nodiscard]] bool IsEmpty() const { return channelMask == 0 && IsChannelOnly(); }
+	[[nodiscard]] bool Matches( const LineData& line ) const;
+
+	// Start and length of every include term found in text, used to highlight them
+	[[nodiscard]] QList < QPair < int, int > > GetHits( const QString& text ) const;
+
+	// Only channel terms, the matching lines are known from the channel indexes without looking at them
+	[[nodiscard]] bool IsChannelOnly() const { return includes.isEmpty() && excludes.isEmpty() && typeMask == 0 && !from.isValid() && !to.isValid(); }
+	[[nodiscard]] quint64 GetChannelMask() const { return channelMask; }
+
+	[[nodiscard]] static quint32 TypeBit( const ePrintType type ) { return 1u << static_cast < int >( type ); }
+
+private:
+	struct Term
+	{
+		QString Text;
+		QRegularExpression Regex;
+		bool IsRegex = false;
+	};
+
+	QList < Term > includes;
+	QList < Term > excludes;
+
+	quint32 typeMask = 0;
+	quint64 channelMask = 0;
+	bool fullLines = false;
+
+	QDateTime from;
+	QDateTime to;
+
+	[[nodiscard]] bool TermMatches( const Term& term, const QString& text ) const;
+	[[nodiscard]] static QDateTime ParseTime( const QString& str );
+
+	static constexpr int MinTermLength = 2;
+};
@@ -0,0 +1,117 @@
+#include "line_query_test.h"
+
+#include <QTest>
+
+#include "line_query.h"
+#include "objects/log_channels/log_channels.h"
+
+static LineData MakeLine( const QString& text, const ePrintType type = ePrintType::PRINT_INFO, const int channel = LogChannels::DefaultChannel, const QDateTime& time = QDateTime::currentDateTime() )
+{
+	return { text, type, time, channel };
+}
+
+void LineQueryTest::EmptyQuery()
+{
+	QVERIFY( LineQuery::Parse( "" ).IsEmpty() );
+	QVERIFY( LineQuery::Parse( " , ," ).IsEmpty() );
+
+	// Too short, still being typed
+	QVERIFY( LineQuery::Parse( "a" ).IsEmpty() );
+	QVERIFY( LineQuery::Parse( "/(/" ).IsEmpty() );
+
+	QVERIFY( LineQuery::Parse( "" ).Matches( MakeLine( "anything" ) ) );
+}
+
+void LineQueryTest::TextTerms()
+{
+	const LineQuery query = LineQuery::Parse( "Disk, network " );
+
+	QVERIFY( !query.IsEmpty() );
+	QVERIFY( !query.IsChannelOnly() );
+
+	QVERIFY( query.Matches( MakeLine( "DISK full" ) ) );
+	QVERIFY( query.Matches( MakeLine( "lost the Network" ) ) );
+	QVERIFY( !query.Matches( MakeLine( "nothing here" ) ) );
+}
+
+void LineQueryTest::RegexTerms()
+{
+	const LineQuery query = LineQuery::Parse( "/^err\\d+$/" );
+
+	QVERIFY( query.Matches( MakeLine( "ERR42" ) ) );
+	QVERIFY( !query.Matches( MakeLine( "ERR42 tail" ) ) );
+}
+
+void LineQueryTest::ExcludeTerms()
+{
+	const LineQuery query = LineQuery::Parse( "disk, -full, !/temp\\w*/" );
+
+	QVERIFY( query.Matches( MakeLine( "disk mounted" ) ) );
+	QVERIFY( !query.Matches( MakeLine( "disk full" ) ) );
+	QVERIFY( !query.Matches( MakeLine( "disk temporary" ) ) );
+
+	// Excludes alone keep every other line
+	QVERIFY( LineQuery::Parse( "-full" ).Matches( MakeLine( "anything" ) ) );
+}
+
+void LineQueryTest::TypeTerms()
+{
+	const LineQuery query = LineQuery::Parse( "type:warning, TYPE: Error, type:unknown" );
+
+	QVERIFY( query.Matches( MakeLine( "a", ePrintType::PRINT_WARNING ) ) );
+	QVERIFY( query.Matches( MakeLine( "a", ePrintType::PRINT_ERROR ) ) );
+	QVERIFY( !query.Matches( MakeLine( "a", ePrintType::PRINT_INFO ) ) );
+	QVERIFY( !query.IsChannelOnly() );
+}
+
+void LineQueryTest::ChannelTerms()
+{
+	const int channel = LogChannels::Register( "line_query_test" );
+	QVERIFY( LogChannels::IsValid( channel ) );
+
+	const LineQuery query = LineQuery::Parse( "channel:line_query_test" );
+
+	QVERIFY( query.IsChannelOnly() );
+	QVERIFY( !query.IsEmpty() );
+	QCOMPARE( query.GetChannelMask(), LogChannels::ChannelBit( channel ) );
+
+	QVERIFY( query.Matches( MakeLine( "a", ePrintType::PRINT_INFO, channel ) ) );
+	QVERIFY( !query.Matches( MakeLine( "a" ) ) );
+
+	// Unknown channels are ignored
+	QVERIFY( LineQuery::Parse( "channel:line_query_test_unknown" ).IsEmpty() );
+	QVERIFY( !LineQuery::Parse( "channel:line_query_test, disk" ).IsChannelOnly() );
+}
+
+void LineQueryTest::TimeTerms()
+{
+	const LineQuery query = LineQuery::Parse( "after:2024-01-02 10:00, before:2024-01-02 11:00:30" );
+
+	QVERIFY( query.Matches( MakeLine( "a", ePrintType::PRINT_INFO, 0, QDateTime( QDate( 2024, 1, 2 ), QTime( 10, 30 ) ) ) ) );
+	QVERIFY( !query.Matches( MakeLine( "a", ePrintType::PRINT_INFO, 0, QDateTime( QDate( 2024, 1, 2 ), QTime( 9, 59 ) ) ) ) );
+	QVERIFY( !query.Matches( MakeLine( "a", ePrintType::PRINT_INFO, 0, QDateTime( QDate( 2024, 1, 2 ), QTime( 11, 1 ) ) ) ) );
+
+	// A time alone is today
+	const LineQuery today = LineQuery::Parse( "after:00:00" );
+	QVERIFY( today.Matches( MakeLine( "a" ) ) );
+	QVERIFY( !today.Matches( MakeLine( "a", ePrintType::PRINT_INFO, 0, QDateTime::currentDateTime().addDays( -1 ) ) ) );
+}
+
+void LineQueryTest::LongLines()
+{
+	const LineData line = MakeLine( QString( LineData::LongLineLength, 'x' ) + "needle" );
+
+	QVERIFY( !LineQuery::Parse( "needle" ).Matches( line ) );
+	QVERIFY( LineQuery::Parse( "needle, scan:full" ).Matches( line ) );
+	QVERIFY( LineQuery::Parse( "/needle$/, scan:full" ).Matches( line ) );
+}
+
+void LineQueryTest::Hits()
+{
+	const auto hits = LineQuery::Parse( "ab, /c+d/, -ab" ).GetHits( "xAByccdAB" );
+
+	QCOMPARE( hits.size(), 3 );
+	QVERIFY( hits.contains( qMakePair( 1, 2 ) ) );
+	QVERIFY( hits.contains( qMakePair( 7, 2 ) ) );
+	QVERIFY( hits.contains( qMakePair( 4, 3 ) ) );
+}
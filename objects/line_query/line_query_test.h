@@ -0,0 +1,17 @@
+#pragma once
+
+#include <QObject>
+
+class LineQueryTest final : public QObject
+{
+	Q_OBJECT private slots:
+	void EmptyQuery();
+	void TextTerms();
+	void RegexTerms();
+	void ExcludeTerms();
+	void TypeTerms();
+	void ChannelTerms();
+	void TimeTerms();
+	void LongLines();
+	void Hits();
+};
@@ -0,0 +1,68 @@
+#include "line_queue.h"
+
+#include <QTimer>
+
+#include "utils/defines.h"
+
+void LineQueue::Push( const QString& text, const ePrintType type )
+{
+	QMutexLocker locker( &mutex );
+
+	pending.push_back( { text, type } );
+	QueueFlush();
+}
+
+void LineQueue::Push( const QList < QueuedLine >& lines )
+{
+	if ( lines.isEmpty() )
+		return;
+
+	QMutexLocker locker( &mutex );
+
+	pending.append( lines );
+	QueueFlush();
+}
+
+int LineQueue::GetPendingCount()
+{
+	QMutexLocker locker( &mutex );
+
+#if defined( QT_6 )
+	return static_cast < int >( pending.size() );
+#elif defined( QT_5 )
+	return pending.size();
+#endif
+}
+
+void LineQueue::QueueFlush()
+{
+	if ( flushQueued )
+		return;
+
+	flushQueued = true;
+	QMetaObject::invokeMethod( this, &LineQueue::Flush, Qt::QueuedConnection );
+}
+
+void LineQueue::Flush()
+{
+	// Too soon after the previous batch, lines pushed until then join this one
+	if ( const qint64 elapsed = lastFlush.isValid() ? lastFlush.elapsed() : FlushInterval; elapsed < FlushInterval )
+	{
+		QTimer::singleShot( static_cast < int >( FlushInterval - elapsed ), this, &LineQueue::Flush );
+		return;
+	}
+
+	lastFlush.start();
+
+	QList < QueuedLine > lines;
+
+	{
+		QMutexLocker locker( &mutex );
+
+		lines.swap( pending );
+		flushQueued = false;
+	}
+
+	if ( !lines.isEmpty() )
+		emit LinesReady( lines );
+}
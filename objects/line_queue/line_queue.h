@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+
+#include "utils/const.h"
+
+struct QueuedLine
+{
+	QString Text;
+	ePrintType Type;
+	int Channel = 0; // LogChannels id
+};
+
+// Collects lines pushed from any thread and hands them over in batches on the thread owning the queue.
+// Only one flush is ever pending, lines pushed meanwhile join it instead of posting their own event.
+// Batches are at least FlushInterval apart, a fast producer gets one batch per frame.
+class LineQueue final : public QObject
+{
+	Q_OBJECT public:
+	explicit LineQueue( QObject* parent = nullptr ) : QObject( parent ) {}
+
+	// Thread safe
+	void Push( const QString& text, ePrintType type );
+	void Push( const QList < QueuedLine >& lines );
+
+	// Thread safe, lines pushed and not handed over yet. Producers wait while it is high
+	[[nodiscard]] int GetPendingCount();
+
+signals:
+	void LinesReady( const QList < QueuedLine >& lines );
+
+private:
+	QMutex mutex;
+	QList < QueuedLine > pending;
+	bool flushQueued = false;
+	QElapsedTimer lastFlush; // Only used from the owning thread
+
+	void QueueFlush();
+	void Flush();
+
+	static constexpr int FlushInterval = 16; // ms
+};
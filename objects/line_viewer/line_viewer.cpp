@@ -0,0 +1,77 @@
+#include "line_viewer.h"
+
+#include <algorithm>
+
+#include <QMimeData>
+#include <QTextBlock>
+
+LineViewer::LineViewer( const QString& line, QWidget* parent ) : QPlainTextEdit( parent ), text( line )
+{
+	setReadOnly( true );
+	setUndoRedoEnabled( false );
+
+	const qsizetype size = text.size();
+
+	QStringList blocks;
+	blocks.reserve( static_cast < int >( size / BlockLength + 1 ) );
+
+	qsizetype start = 0;
+	qsizetype newline = text.indexOf( '\n' );
+
+	for ( ;; )
+	{
+		qsizetype end = std::min < qsizetype >( start + BlockLength, size );
+		const bool lineFeed = newline != -1 && newline <= end;
+
+		if ( lineFeed )
+			end = newline;
+		else if ( end < size && text[ end - 1 ].isHighSurrogate() )
+			--end;
+
+		blockStarts.push_back( start );
+		blocks.push_back( text.mid( start, end - start ) );
+
+		// A line feed of the text becomes the block break, the other breaks are not part of it
+		if ( lineFeed )
+		{
+			start = end + 1;
+			newline = text.indexOf( '\n', start );
+		}
+		else if ( end == size )
+		{
+			break;
+		}
+		else
+		{
+			start = end;
+		}
+	}
+
+	setPlainText( blocks.join( '\n' ) );
+}
+
+qsizetype LineViewer::GetLineOffset( const int position ) const
+{
+	const QTextBlock block = document()->findBlock( position );
+
+	if ( !block.isValid() )
+		return text.size();
+
+	return std::min( blockStarts[ block.blockNumber() ] + position - block.position(), text.size() );
+}
+
+QString LineViewer::GetSelectedLineText() const
+{
+	const QTextCursor cursor = textCursor();
+	const qsizetype start = GetLineOffset( cursor.selectionStart() );
+
+	return text.mid( start, GetLineOffset( cursor.selectionEnd() ) - start );
+}
+
+QMimeData* LineViewer::createMimeDataFromSelection() const
+{
+	auto* mimeData = new QMimeData;
+	mimeData->setText( GetSelectedLineText() );
+
+	return mimeData;
+}
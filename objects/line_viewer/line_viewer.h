@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QPlainTextEdit>
+
+// Read-only view of a whole console line, however long.
+// The line is shown in blocks of at most BlockLength characters, QPlainTextEdit only lays out the blocks scrolled to.
+// Blocks break at the line feeds of the text and never inside a surrogate pair, copying gives back the original text.
+class LineViewer final : public QPlainTextEdit
+{
+public:
+	explicit LineViewer( const QString& line, QWidget* parent = nullptr );
+
+	[[nodiscard]] const QString& GetLine() const { return text; }
+
+	// Offset in the line of a document position
+	[[nodiscard]] qsizetype GetLineOffset( int position ) const;
+	[[nodiscard]] QString GetSelectedLineText() const;
+
+	static constexpr int BlockLength = 1024;
+
+protected:
+	QMimeData* createMimeDataFromSelection() const override;
+
+private:
+	QString text;
+	QList < qsizetype > blockStarts; // Offset in the line of the first character of each block
+};
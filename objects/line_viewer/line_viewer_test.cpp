@@ -0,0 +1,78 @@
+#include "line_viewer_test.h"
+
+#include <QElapsedTimer>
+#include <QTest>
+#include <QTextBlock>
+
+#include "line_viewer.h"
+
+static constexpr int LargeLineLength = 10 * 1024 * 1024;
+static constexpr qint64 MaxExpandTime = 500; // ms, a whole layout of the line takes seconds
+
+void LineViewerTest::LargeLineDoesNotBlock()
+{
+	const QString line( LargeLineLength, 'x' );
+
+	QElapsedTimer timer;
+	timer.start();
+
+	LineViewer viewer( line );
+	viewer.resize( 900, 600 );
+	viewer.show();
+	QCoreApplication::processEvents();
+
+	QVERIFY2( timer.elapsed() < MaxExpandTime, qPrintable( QString( "Expanding took %1 ms" ).arg( timer.elapsed() ) ) );
+	QCOMPARE( viewer.blockCount(), LargeLineLength / LineViewer::BlockLength );
+}
+
+void LineViewerTest::BlocksKeepSurrogatePairs()
+{
+	// Odd prefix so that every BlockLength boundary falls between the two halves of a pair
+	const QString pair = QString::fromUcs4( U"\U0001F600" );
+	QString line = "a";
+
+	while ( line.size() < 4 * LineViewer::BlockLength )
+		line += pair;
+
+	const LineViewer viewer( line );
+
+	for ( QTextBlock block = viewer.document()->begin(); block.isValid(); block = block.next() )
+	{
+		const QString text = block.text();
+
+		QVERIFY( !text.isEmpty() );
+		QVERIFY( !text.back().isHighSurrogate() );
+		QVERIFY( !text.front().isLowSurrogate() );
+	}
+}
+
+void LineViewerTest::CopyGivesOriginalText()
+{
+	QString line = QString( LineViewer::BlockLength + 10, 'a' ) + '\n' + QString( 3 * LineViewer::BlockLength, 'b' ) + "\n\nend\n";
+	line[ LineViewer::BlockLength / 2 ] = '\t';
+
+	LineViewer viewer( line );
+	viewer.selectAll();
+
+	QCOMPARE( viewer.GetSelectedLineText(), line );
+
+	// Selection starting in a later block, across a break that is not part of the line
+	QTextCursor cursor( viewer.document()->findBlockByNumber( 2 ) );
+	cursor.setPosition( cursor.position() + 5 );
+	cursor.setPosition( viewer.document()->findBlockByNumber( 4 ).position() + 2, QTextCursor::KeepAnchor );
+	viewer.setTextCursor( cursor );
+
+	const qsizetype secondLine = LineViewer::BlockLength + 11;
+	const qsizetype start = secondLine + 5;
+	const qsizetype end = secondLine + 2 * LineViewer::BlockLength + 2;
+	QCOMPARE( viewer.GetSelectedLineText(), line.mid( start, end - start ) );
+}
+
+void LineViewerTest::EmptyLine()
+{
+	LineViewer viewer( QString() );
+	viewer.selectAll();
+
+	QCOMPARE( viewer.blockCount(), 1 );
+	QVERIFY( viewer.GetSelectedLineText().isEmpty() );
+}
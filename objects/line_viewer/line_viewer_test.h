@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QObject>
+
+class LineViewerTest final : public QObject
+{
+	Q_OBJECT private slots:
+	void LargeLineDoesNotBlock();
+	void BlocksKeepSurrogatePairs();
+	void CopyGivesOriginalText();
+	void EmptyLine();
+};
@@ -0,0 +1,64 @@
+#include "log_channels.h"
+
+#include "utils/defines.h"
+
+int LogChannels::Register( const QString& name )
+{
+	QMutexLocker locker( &mutex );
+
+	if ( const int channel = Find( name ); channel != -1 )
+		return channel;
+
+	const int channel = count.load( std::memory_order_relaxed );
+
+	if ( channel == MaxChannels )
+		return InvalidChannel;
+
+	// Written before the count is raised, readers never see a slot being filled
+	names[ channel ] = name;
+	count.store( channel + 1, std::memory_order_release );
+
+	return channel;
+}
+
+int LogChannels::Find( const QString& name )
+{
+	const int size = count.load( std::memory_order_acquire );
+
+	for ( int channel = 0; channel < size; ++channel )
+	{
+		if ( names[ channel ] == name )
+			return channel;
+	}
+
+	return -1;
+}
+
+QString LogChannels::GetName( const int channel )
+{
+	return channel >= 0 && channel < count.load( std::memory_order_acquire ) ? names[ channel ] : QString();
+}
+
+QStringList LogChannels::GetNames()
+{
+	const int size = count.load( std::memory_order_acquire );
+
+	QStringList result;
+	result.reserve( size );
+
+	for ( int channel = 0; channel < size; ++channel )
+		result.push_back( names[ channel ] );
+
+	return result;
+}
+
+void LogChannels::SetMuted( const int channel, const bool muted )
+{
+	if ( !IsValid( channel ) )
+		return;
+
+	if ( muted )
+		mutedMask.fetch_or( ChannelBit( channel ), std::memory_order_relaxed );
+	else
+		mutedMask.fetch_and( ~ChannelBit( channel ), std::memory_order_relaxed );
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include <QMutex>
+#include <QStringList>
+
+#include "console_widget_global.h"
+
+// Named log channels, registered once and referred to by a small id afterwards.
+// Lines of a muted channel are dropped by the producers before being formatted. Thread safe,
+// names never change once registered so only Register takes the lock.
+class CONSOLE_WIDGET_EXPORT LogChannels final
+{
+public:
+	// Returns the id of the channel, registering it the first time. InvalidChannel is returned once MaxChannels are registered
+	static int Register( const QString& name );
+
+	// Returns -1 when there is no channel with this name
+	[[nodiscard]] static int Find( const QString& name );
+	[[nodiscard]] static QString GetName( int channel );
+	[[nodiscard]] static QStringList GetNames();
+
+	static void SetMuted( int channel, bool muted );
+	[[nodiscard]] static bool IsMuted( const int channel ) { return IsValid( channel ) && ( mutedMask.load( std::memory_order_relaxed ) & ChannelBit( channel ) ) != 0; }
+
+	[[nodiscard]] static bool IsValid( const int channel ) { return channel >= 0 && channel < MaxChannels; }
+	[[nodiscard]] static quint64 ChannelBit( const int channel ) { return quint64( 1 ) << channel; }
+
+	static constexpr int DefaultChannel = 0;
+	static constexpr int InvalidChannel = -1;
+	static constexpr int MaxChannels = 64;
+
+private:
+	inline static QMutex mutex; // Serializes Register
+	inline static std::array < QString, MaxChannels > names = { "default" };
+	inline static std::atomic < int > count = 1; // Names below count are published and read without the lock
+	inline static std::atomic < quint64 > mutedMask = 0;
+};
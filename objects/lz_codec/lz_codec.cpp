@@ -0,0 +1,150 @@
+#include "lz_codec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+static quint32 Read32( const uchar* data )
+{
+	quint32 value;
+	std::memcpy( &value, data, sizeof( value ) );
+	return value;
+}
+
+static uchar* WriteLength( uchar* out, int length )
+{
+	for ( ; length >= 255; length -= 255 )
+		*out++ = 255;
+
+	*out++ = static_cast < uchar >( length );
+	return out;
+}
+
+static bool ReadLength( const uchar*& in, const uchar* end, int& length )
+{
+	uchar byte;
+
+	do
+	{
+		if ( in == end )
+			return false;
+
+		byte = *in++;
+		length += byte;
+	} while ( byte == 255 );
+
+	return true;
+}
+
+static uchar* WriteLiterals( uchar* out, uchar token, const uchar* literals, const int length )
+{
+	*out++ = static_cast < uchar >( token | std::min( length, 15 ) << 4 );
+
+	if ( length >= 15 )
+		out = WriteLength( out, length - 15 );
+
+	std::memcpy( out, literals, length );
+	return out + length;
+}
+
+int LzCodec::Compress( const char* input, const int size, char* output )
+{
+	const auto* src = reinterpret_cast < const uchar* >( input );
+	auto* out = reinterpret_cast < uchar* >( output );
+
+	// Last position of each hashed 4 bytes sequence
+	std::vector < int > table( 1 << HashBits, -1 );
+
+	int anchor = 0;
+
+	for ( int i = 0; i <= size - MinMatch; )
+	{
+		const quint32 sequence = Read32( src + i );
+		const quint32 hash = sequence * 2654435761u >> ( 32 - HashBits );
+
+		const int candidate = table[ hash ];
+		table[ hash ] = i;
+
+		if ( candidate < 0 || i - candidate > MaxOffset || Read32( src + candidate ) != sequence )
+		{
+			// Step faster through data that does not compress
+			i += 1 + ( ( i - anchor ) >> 6 );
+			continue;
+		}
+
+		int length = MinMatch;
+		while ( i + length < size && src[ candidate + length ] == src[ i + length ] )
+			++length;
+
+		const int matchCode = length - MinMatch;
+
+		out = WriteLiterals( out, static_cast < uchar >( std::min( matchCode, 15 ) ), src + anchor, i - anchor );
+
+		const int offset = i - candidate;
+		*out++ = static_cast < uchar >( offset & 0xFF );
+		*out++ = static_cast < uchar >( offset >> 8 );
+
+		if ( matchCode >= 15 )
+			out = WriteLength( out, matchCode - 15 );
+
+		i += length;
+		anchor = i;
+	}
+
+	out = WriteLiterals( out, 0, src + anchor, size - anchor );
+
+	return static_cast < int >( out - reinterpret_cast < uchar* >( output ) );
+}
+
+bool LzCodec::Decompress( const char* input, const int size, char* output, const int outputSize )
+{
+	const auto* in = reinterpret_cast < const uchar* >( input );
+	const uchar* end = in + size;
+
+	char* out = output;
+	const char* outEnd = output + outputSize;
+
+	while ( in < end )
+	{
+		const uchar token = *in++;
+
+		int literalLength = token >> 4;
+		if ( literalLength == 15 && !ReadLength( in, end, literalLength ) )
+			return false;
+
+		if ( end - in < literalLength || outEnd - out < literalLength )
+			return false;
+
+		std::memcpy( out, in, literalLength );
+		in += literalLength;
+		out += literalLength;
+
+		// Last sequence
+		if ( in == end )
+			break;
+
+		if ( end - in < 2 )
+			return false;
+
+		const int offset = in[ 0 ] | in[ 1 ] << 8;
+		in += 2;
+
+		int matchLength = token & 15;
+		if ( matchLength == 15 && !ReadLength( in, end, matchLength ) )
+			return false;
+
+		matchLength += MinMatch;
+
+		if ( offset == 0 || offset > out - output || outEnd - out < matchLength )
+			return false;
+
+		// Byte per byte, the match may overlap the bytes being written
+		const char* match = out - offset;
+		for ( int i = 0; i < matchLength; ++i )
+			out[ i ] = match[ i ];
+
+		out += matchLength;
+	}
+
+	return out == outEnd;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QtGlobal>
+
+// Small LZ77 codec with an LZ4 style layout, used to pack console history.
+// Each sequence is a token ( literal length << 4 | match length - 4 ), the literals, a 16 bits little endian offset and the match.
+// Lengths of 15 and more continue in the following bytes, the last sequence has no match.
+class LzCodec final
+{
+public:
+	// Worst case size of the compressed data, the output buffer given to Compress must be this large
+	[[nodiscard]] static int GetMaxCompressedSize( const int size ) { return size + size / 255 + 16; }
+
+	// Returns the compressed size
+	static int Compress( const char* input, int size, char* output );
+
+	// The decompressed size is not stored, outputSize must be exact. Returns false on corrupted data
+	static bool Decompress( const char* input, int size, char* output, int outputSize );
+
+private:
+	static constexpr int MinMatch = 4;
+	static constexpr int MaxOffset = 0xFFFF;
+	static constexpr int HashBits = 14;
+};
@@ -0,0 +1,87 @@
+#include "lz_codec_test.h"
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include "lz_codec.h"
+
+static QByteArray Compress( const QByteArray& input )
+{
+	const int size = static_cast < int >( input.size() );
+
+	QByteArray output( LzCodec::GetMaxCompressedSize( size ), Qt::Uninitialized );
+	output.resize( LzCodec::Compress( input.constData(), size, output.data() ) );
+
+	return output;
+}
+
+static bool RoundTrips( const QByteArray& input )
+{
+	const QByteArray compressed = Compress( input );
+
+	if ( compressed.size() > LzCodec::GetMaxCompressedSize( static_cast < int >( input.size() ) ) )
+		return false;
+
+	QByteArray output( input.size(), Qt::Uninitialized );
+
+	return LzCodec::Decompress( compressed.constData(), static_cast < int >( compressed.size() ), output.data(), static_cast < int >( output.size() ) ) && output == input;
+}
+
+void LzCodecTest::Empty()
+{
+	QVERIFY( RoundTrips( QByteArray() ) );
+	QVERIFY( RoundTrips( QByteArray( "abc" ) ) );
+}
+
+void LzCodecTest::Incompressible()
+{
+	QRandomGenerator generator( 42 );
+	QByteArray input( 100000, Qt::Uninitialized );
+
+	for ( char& byte : input )
+		byte = static_cast < char >( generator.bounded( 256 ) );
+
+	QVERIFY( RoundTrips( input ) );
+}
+
+void LzCodecTest::Repetitive()
+{
+	const QByteArray input = QByteArray( "[2024-01-02 10:00:00] [INFO]     tick\n" ).repeated( 30000 );
+
+	QVERIFY( RoundTrips( input ) );
+	QVERIFY( Compress( input ).size() < input.size() / 50 );
+
+	// Long runs of a single byte, the match overlaps the bytes it writes
+	QVERIFY( RoundTrips( QByteArray( 70000, 'x' ) ) );
+}
+
+void LzCodecTest::LargerThanWindow()
+{
+	// Repeats farther apart than the 64 KiB offsets can reach, and lengths past the 255 continuation bytes
+	QRandomGenerator generator( 7 );
+	QByteArray chunk( 40000, Qt::Uninitialized );
+
+	for ( char& byte : chunk )
+		byte = static_cast < char >( 'a' + generator.bounded( 26 ) );
+
+	QByteArray input = chunk + QByteArray( 1000, '-' ) + chunk.left( 30000 );
+	input += chunk + chunk.mid( 123 ) + QByteArray( 5000, 'z' );
+
+	QVERIFY( input.size() > 64 * 1024 );
+	QVERIFY( RoundTrips( input ) );
+}
+
+void LzCodecTest::CorruptedInput()
+{
+	const QByteArray input = QByteArray( "some line of text, some line of text\n" ).repeated( 100 );
+	const QByteArray compressed = Compress( input );
+	QByteArray output( input.size(), Qt::Uninitialized );
+
+	// Truncated, or told the wrong size, it fails instead of writing past the output
+	QVERIFY( !LzCodec::Decompress( compressed.constData(), static_cast < int >( compressed.size() ) - 3, output.data(), static_cast < int >( output.size() ) ) );
+	QVERIFY( !LzCodec::Decompress( compressed.constData(), static_cast < int >( compressed.size() ), output.data(), static_cast < int >( output.size() ) - 1 ) );
+
+	// An offset before the start of the output
+	const char badOffset[] = { 0x10, 'a', 0x10, 0x00 };
+	QVERIFY( !LzCodec::Decompress( badOffset, sizeof( badOffset ), output.data(), 5 ) );
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <QObject>
+
+class LzCodecTest final : public QObject
+{
+	Q_OBJECT private slots:
+	void Empty();
+	void Incompressible();
+	void Repetitive();
+	void LargerThanWindow();
+	void CorruptedInput();
+};
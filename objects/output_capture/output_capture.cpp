@@ -0,0 +1,237 @@
+#include "output_capture.h"
+
+#include <cerrno>
+#include <cstdio>
+
+#include "objects/console_core/console_core.h"
+
+#if defined( Q_OS_WIN )
+# include <fcntl.h>
+# include <io.h>
+# include <windows.h>
+#else
+# include <unistd.h>
+#endif
+
+#if defined( Q_OS_WIN )
+static int OpenPipe( int fds[ 2 ] ) { return _pipe( fds, 64 * 1024, _O_BINARY | _O_NOINHERIT ); }
+static int DuplicateFd( const int fd ) { return _dup( fd ); }
+static int DuplicateFdTo( const int fd, const int target ) { return _dup2( fd, target ); }
+static int CloseFd( const int fd ) { return _close( fd ); }
+static qint64 ReadFd( const int fd, char* data, const int size ) { return _read( fd, data, size ); }
+static qint64 WriteFd( const int fd, const char* data, const qint64 size ) { return _write( fd, data, static_cast < unsigned int >( size ) ); }
+
+// Native handles are used by code writing with WriteFile / WriteConsole instead of the CRT
+static void SetNativeHandle( const int fd ) { SetStdHandle( fd == 1 ? STD_OUTPUT_HANDLE : STD_ERROR_HANDLE, reinterpret_cast < HANDLE >( _get_osfhandle( fd ) ) ); }
+#else
+static int OpenPipe( int fds[ 2 ] ) { return pipe( fds ); }
+static int DuplicateFd( const int fd ) { return dup( fd ); }
+static int DuplicateFdTo( const int fd, const int target ) { return dup2( fd, target ); }
+static int CloseFd( const int fd ) { return close( fd ); }
+static qint64 ReadFd( const int fd, char* data, const int size ) { return read( fd, data, size ); }
+static qint64 WriteFd( const int fd, const char* data, const qint64 size ) { return write( fd, data, static_cast < size_t >( size ) ); }
+static void SetNativeHandle( int ) {}
+#endif
+
+void OutputCapture::InstallMessageHandler( const bool tee )
+{
+	if ( messageHandlerInstalled )
+		return;
+
+	GetQueue();
+
+	teeMessages = tee;
+	previousHandler = qInstallMessageHandler( &OutputCapture::MessageHandler );
+	messageHandlerInstalled = true;
+}
+
+void OutputCapture::RemoveMessageHandler()
+{
+	if ( !messageHandlerInstalled )
+		return;
+
+	qInstallMessageHandler( previousHandler );
+	previousHandler = nullptr;
+	messageHandlerInstalled = false;
+}
+
+bool OutputCapture::CaptureStdStreams( const bool tee )
+{
+	if ( IsCapturingStdStreams() )
+		return true;
+
+	GetQueue();
+
+	teeStreams = tee;
+
+	if ( !CaptureStream( streams[ 0 ] ) )
+		return false;
+
+	if ( !CaptureStream( streams[ 1 ] ) )
+	{
+		ReleaseStream( streams[ 0 ] );
+		return false;
+	}
+
+	return true;
+}
+
+void OutputCapture::ReleaseStdStreams()
+{
+	ReleaseStream( streams[ 0 ] );
+	ReleaseStream( streams[ 1 ] );
+}
+
+LineQueue* OutputCapture::GetQueue()
+{
+	// Never deleted, reader threads and message handlers may still push while the application shuts down
+	if ( !queue )
+	{
+		queue = new LineQueue;
+
+		QObject::connect( queue, &LineQueue::LinesReady, []( const QList < QueuedLine >& lines )
+		{
+			for ( ConsoleCore* console : ConsoleCore::GetCores() )
+			{
+				if ( console )
+					console->AddLines( lines );
+			}
+		} );
+	}
+
+	return queue;
+}
+
+void OutputCapture::MessageHandler( const QtMsgType msgType, const QMessageLogContext& context, const QString& message )
+{
+	ePrintType type = ePrintType::PRINT_INFO;
+
+	switch ( msgType )
+	{
+	case QtDebugMsg:
+		type = ePrintType::PRINT_INFO;
+		break;
+	case QtInfoMsg:
+		type = ePrintType::PRINT_NOTICE;
+		break;
+	case QtWarningMsg:
+		type = ePrintType::PRINT_WARNING;
+		break;
+	case QtCriticalMsg:
+	case QtFatalMsg:
+		type = ePrintType::PRINT_ERROR;
+		break;
+	}
+
+	queue->Push( message, type );
+
+	// A fatal message aborts before reaching the console, always make it visible somewhere
+	if ( !teeMessages && msgType != QtFatalMsg )
+		return;
+
+	// The previous handler writes to stderr which would come back through the capture pipe
+	if ( IsCapturingStdStreams() )
+	{
+		const QByteArray formatted = qFormatLogMessage( msgType, context, message ).toLocal8Bit() + '\n';
+		WriteFd( streams[ 1 ].OriginalFd, formatted.constData(), formatted.size() );
+	}
+	else if ( previousHandler )
+	{
+		previousHandler( msgType, context, message );
+	}
+}
+
+bool OutputCapture::CaptureStream( StreamCapture& stream )
+{
+	std::fflush( stream.Fd == 1 ? stdout : stderr );
+
+	int fds[ 2 ];
+	if ( OpenPipe( fds ) != 0 )
+		return false;
+
+	stream.OriginalFd = DuplicateFd( stream.Fd );
+
+	if ( stream.OriginalFd == -1 || DuplicateFdTo( fds[ 1 ], stream.Fd ) == -1 )
+	{
+		if ( stream.OriginalFd != -1 )
+			CloseFd( stream.OriginalFd );
+
+		CloseFd( fds[ 0 ] );
+		CloseFd( fds[ 1 ] );
+
+		stream.OriginalFd = -1;
+		return false;
+	}
+
+	// The redirected descriptor is now the only write end, restoring it later ends the reader
+	CloseFd( fds[ 1 ] );
+	SetNativeHandle( stream.Fd );
+
+	stream.ReadFd = fds[ 0 ];
+	stream.Reader = std::thread( &OutputCapture::ReadStream, &stream );
+
+	return true;
+}
+
+void OutputCapture::ReleaseStream( StreamCapture& stream )
+{
+	if ( stream.OriginalFd == -1 )
+		return;
+
+	std::fflush( stream.Fd == 1 ? stdout : stderr );
+
+	DuplicateFdTo( stream.OriginalFd, stream.Fd );
+	SetNativeHandle( stream.Fd );
+
+	if ( stream.Reader.joinable() )
+		stream.Reader.join();
+
+	CloseFd( stream.OriginalFd );
+	CloseFd( stream.ReadFd );
+
+	stream.OriginalFd = -1;
+	stream.ReadFd = -1;
+}
+
+void OutputCapture::ReadStream( const StreamCapture* stream )
+{
+	QByteArray buffer( ReadBufferSize, Qt::Uninitialized );
+	QByteArray partial;
+
+	for ( ;; )
+	{
+		const qint64 count = ReadFd( stream->ReadFd, buffer.data(), ReadBufferSize );
+
+		if ( count < 0 && errno == EINTR )
+			continue;
+
+		if ( count <= 0 )
+			break;
+
+		if ( teeStreams )
+			WriteFd( stream->OriginalFd, buffer.constData(), count );
+
+		partial.append( buffer.constData(), static_cast < int >( count ) );
+
+		// Every complete line read in this chunk goes to the GUI thread in one batch
+		QList < QueuedLine > lines;
+		int start = 0;
+
+		for ( int end = static_cast < int >( partial.indexOf( '\n' ) ); end != -1; end = static_cast < int >( partial.indexOf( '\n', start ) ) )
+		{
+			int length = end - start;
+
+			if ( length > 0 && partial.at( end - 1 ) == '\r' )
+				--length;
+
+			lines.push_back( { QString::fromLocal8Bit( partial.constData() + start, length ), stream->Type } );
+			start = end + 1;
+		}
+
+		partial.remove( 0, start );
+		queue->Push( lines );
+	}
+
+	if ( !partial.isEmpty() )
+		queue->Push( QString::fromLocal8Bit( partial ), stream->Type );
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <thread>
+
+#include <QtGlobal>
+
+#include "objects/line_queue/line_queue.h"
+
+// Opt-in capture of output that does not go through ConsoleCore::Print.
+// Captured lines are batched and added to every console on the GUI thread.
+// Must be installed and released from the GUI thread.
+class OutputCapture final
+{
+public:
+	// Routes qDebug / qInfo / qWarning / qCritical into the consoles, tee also forwards them to the previous handler
+	static void InstallMessageHandler( bool tee = false );
+	static void RemoveMessageHandler();
+
+	// Redirects file descriptors 1 and 2 through pipes read by a dedicated thread, tee also writes to the original streams
+	static bool CaptureStdStreams( bool tee = false );
+	static void ReleaseStdStreams();
+
+	[[nodiscard]] static bool IsCapturingStdStreams() { return streams[ 0 ].OriginalFd != -1; }
+
+private:
+	struct StreamCapture
+	{
+		int Fd;
+		ePrintType Type;
+		int OriginalFd = -1;
+		int ReadFd = -1;
+		std::thread Reader;
+	};
+
+	inline static QtMessageHandler previousHandler = nullptr;
+	inline static bool messageHandlerInstalled = false;
+	inline static bool teeMessages = false;
+
+	inline static StreamCapture streams[ 2 ] = { { 1, ePrintType::PRINT_INFO }, { 2, ePrintType::PRINT_ERROR } };
+	inline static bool teeStreams = false;
+
+	inline static LineQueue* queue = nullptr;
+
+	static LineQueue* GetQueue();
+
+	static void MessageHandler( QtMsgType msgType, const QMessageLogContext& context, const QString& message );
+
+	static bool CaptureStream( StreamCapture& stream );
+	static void ReleaseStream( StreamCapture& stream );
+	static void ReadStream( const StreamCapture* stream );
+
+	static constexpr int ReadBufferSize = 64 * 1024;
+};
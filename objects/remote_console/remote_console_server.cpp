@@ -0,0 +1,162 @@
+#include "remote_console_server.h"
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTimer>
+
+#include "remote_protocol.h"
+
+RemoteConsoleServer::RemoteConsoleServer( ConsoleCore* consoleCore, QObject* parent ) : QObject( parent ), core( consoleCore ), server( new QLocalServer( this ) )
+{
+	// Only the user running the console may drive it
+	server->setSocketOptions( QLocalServer::UserAccessOption );
+
+	connect( server, &QLocalServer::newConnection, this, &RemoteConsoleServer::OnNewConnection );
+	connect( core, &ConsoleCore::LineAdded, this, &RemoteConsoleServer::OnLineAdded );
+}
+
+RemoteConsoleServer::~RemoteConsoleServer() { Close(); }
+
+bool RemoteConsoleServer::Listen( const QString& name )
+{
+	Close();
+
+	// Left behind by a previous instance that did not shut down cleanly
+	QLocalServer::removeServer( name );
+
+	return server->listen( name );
+}
+
+void RemoteConsoleServer::Close()
+{
+	for ( QLocalSocket* socket : clients.keys() )
+	{
+		socket->disconnect( this );
+		socket->abort();
+		socket->deleteLater();
+	}
+
+	clients.clear();
+	server->close();
+}
+
+bool RemoteConsoleServer::IsListening() const { return server->isListening(); }
+
+QString RemoteConsoleServer::GetServerName() const { return server->fullServerName(); }
+
+void RemoteConsoleServer::OnNewConnection()
+{
+	while ( QLocalSocket* socket = server->nextPendingConnection() )
+	{
+		clients.insert( socket, Client() );
+
+		connect( socket, &QLocalSocket::readyRead, this, [ this, socket ] { ReadClient( socket ); } );
+		connect( socket, &QLocalSocket::disconnected, this, [ this, socket ] { RemoveClient( socket ); } );
+	}
+}
+
+void RemoteConsoleServer::OnLineAdded( const LineData& line )
+{
+	if ( clients.isEmpty() )
+		return;
+
+	// Encoded once, shared by every client accepting the line
+	QByteArray record;
+
+	for ( auto it = clients.begin(); it != clients.end(); ++it )
+	{
+		Client& client = it.value();
+
+		if ( !client.Filter.IsEmpty() && !client.Filter.Matches( line ) )
+			continue;
+
+		if ( record.isEmpty() )
+			RemoteProtocol::AppendLineRecord( record, line );
+
+		if ( it.key()->bytesToWrite() + client.PendingRecords.size() + record.size() > MaxClientBuffer )
+		{
+			++client.DroppedCount;
+			continue;
+		}
+
+		client.PendingRecords.append( record );
+		++client.PendingCount;
+	}
+
+	if ( !flushQueued && !record.isEmpty() )
+	{
+		flushQueued = true;
+		QTimer::singleShot( FlushInterval, this, &RemoteConsoleServer::FlushClients );
+	}
+}
+
+void RemoteConsoleServer::FlushClients()
+{
+	flushQueued = false;
+
+	for ( auto it = clients.begin(); it != clients.end(); ++it )
+	{
+		Client& client = it.value();
+
+		if ( client.DroppedCount > 0 )
+		{
+			it.key()->write( RemoteProtocol::EncodeDropped( client.DroppedCount ) );
+			client.DroppedCount = 0;
+		}
+
+		if ( client.PendingCount > 0 )
+		{
+			it.key()->write( RemoteProtocol::EncodeLines( client.PendingRecords, client.PendingCount ) );
+			client.PendingRecords.clear();
+			client.PendingCount = 0;
+		}
+	}
+}
+
+void RemoteConsoleServer::ReadClient( QLocalSocket* socket )
+{
+	const auto it = clients.find( socket );
+
+	if ( it == clients.end() )
+		return;
+
+	QByteArray& incoming = it->Incoming;
+	incoming.append( socket->readAll() );
+
+	eRemoteMessage type;
+	QByteArray payload;
+
+	for ( ;; )
+	{
+		const RemoteProtocol::eReadResult result = RemoteProtocol::ReadFrame( incoming, type, payload, MaxClientPayload );
+
+		if ( result == RemoteProtocol::eReadResult::READ_INCOMPLETE )
+			break;
+
+		if ( result == RemoteProtocol::eReadResult::READ_INVALID )
+		{
+			socket->abort();
+			return;
+		}
+
+		switch ( type )
+		{
+		case eRemoteMessage::MESSAGE_COMMAND:
+			// May print, which appends to the client buffers, but never adds or removes clients.
+			// Only commands typed locally are kept in the history file
+			core->ExecuteCommand( QString::fromUtf8( payload ).trimmed(), false );
+			break;
+		case eRemoteMessage::MESSAGE_SET_FILTER:
+			it->Filter = LineQuery::Parse( QString::fromUtf8( payload ) );
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void RemoteConsoleServer::RemoveClient( QLocalSocket* socket )
+{
+	clients.remove( socket );
+	socket->deleteLater();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+
+#include "objects/console_core/console_core.h"
+#include "objects/line_query/line_query.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+// Optional local socket endpoint for a console core ( named pipe on Windows, Unix socket elsewhere ).
+// Commands received are dispatched like the ones typed in the console, the console lines are streamed back
+// in batches using RemoteProtocol framing. Each client has its own filter and a bounded output buffer,
+// lines for a client that does not keep up are dropped and reported instead of stalling the console.
+class CONSOLE_WIDGET_EXPORT RemoteConsoleServer final : public QObject
+{
+	Q_OBJECT public:
+	explicit RemoteConsoleServer( ConsoleCore* consoleCore, QObject* parent = nullptr );
+	~RemoteConsoleServer() override;
+
+	bool Listen( const QString& name );
+	void Close();
+
+	[[nodiscard]] bool IsListening() const;
+	[[nodiscard]] QString GetServerName() const;
+#if defined( QT_6 )
+	[[nodiscard]] int GetClientCount() const { return static_cast < int >( clients.size() ); }
+#elif defined( QT_5 )
+	[[nodiscard]] int GetClientCount() const { return clients.size(); }
+#endif
+
+private slots:
+	void OnNewConnection();
+	void OnLineAdded( const LineData& line );
+	void FlushClients();
+
+private:
+	struct Client
+	{
+		QByteArray Incoming;
+		LineQuery Filter;
+		QByteArray PendingRecords;
+		quint32 PendingCount = 0;
+		quint32 DroppedCount = 0;
+	};
+
+	ConsoleCore* core;
+	QLocalServer* server;
+	QHash < QLocalSocket*, Client > clients;
+	bool flushQueued = false;
+
+	void ReadClient( QLocalSocket* socket );
+	void RemoveClient( QLocalSocket* socket );
+
+	static constexpr qint64 MaxClientBuffer = 4 * 1024 * 1024;
+	static constexpr quint32 MaxClientPayload = 64 * 1024;
+	static constexpr int FlushInterval = 16; // ms
+};
@@ -0,0 +1,141 @@
+#include "remote_protocol.h"
+
+#include <QtEndian>
+
+QByteArray RemoteProtocol::EncodeFrame( const eRemoteMessage type, const QByteArray& payload )
+{
+	QByteArray frame;
+	frame.reserve( HeaderSize + payload.size() );
+
+	AppendUInt32( frame, static_cast < quint32 >( payload.size() ) );
+	frame.append( static_cast < char >( type ) );
+	frame.append( payload );
+
+	return frame;
+}
+
+QByteArray RemoteProtocol::EncodeLines( const QByteArray& records, const quint32 count )
+{
+	QByteArray frame;
+	frame.reserve( HeaderSize + 4 + records.size() );
+
+	AppendUInt32( frame, static_cast < quint32 >( 4 + records.size() ) );
+	frame.append( static_cast < char >( eRemoteMessage::MESSAGE_LINES ) );
+	AppendUInt32( frame, count );
+	frame.append( records );
+
+	return frame;
+}
+
+QByteArray RemoteProtocol::EncodeDropped( const quint32 count )
+{
+	QByteArray payload;
+	AppendUInt32( payload, count );
+
+	return EncodeFrame( eRemoteMessage::MESSAGE_DROPPED, payload );
+}
+
+void RemoteProtocol::AppendLineRecord( QByteArray& records, const LineData& line )
+{
+	// The size is sent on 16 bits, longer names are cut
+	const QByteArray channel = LogChannels::GetName( line.Channel ).toUtf8().left( 0xFFFF );
+	const QByteArray text = line.Text.toUtf8();
+
+	records.append( static_cast < char >( line.Type ) );
+	AppendInt64( records, line.Time.toMSecsSinceEpoch() );
+	AppendUInt16( records, static_cast < quint16 >( channel.size() ) );
+	records.append( channel );
+	AppendUInt32( records, static_cast < quint32 >( text.size() ) );
+	records.append( text );
+}
+
+RemoteProtocol::eReadResult RemoteProtocol::ReadFrame( QByteArray& buffer, eRemoteMessage& type, QByteArray& payload, const quint32 maxPayloadSize )
+{
+	if ( buffer.size() < HeaderSize )
+		return eReadResult::READ_INCOMPLETE;
+
+	const auto size = qFromLittleEndian < quint32 >( buffer.constData() );
+
+	if ( size > maxPayloadSize )
+		return eReadResult::READ_INVALID;
+
+	if ( static_cast < quint64 >( buffer.size() ) < HeaderSize + static_cast < quint64 >( size ) )
+		return eReadResult::READ_INCOMPLETE;
+
+	type = static_cast < eRemoteMessage >( buffer.at( 4 ) );
+	payload = buffer.mid( HeaderSize, static_cast < int >( size ) );
+	buffer.remove( 0, HeaderSize + static_cast < int >( size ) );
+
+	return eReadResult::READ_FRAME;
+}
+
+QList < LineData > RemoteProtocol::DecodeLines( const QByteArray& payload )
+{
+	QList < LineData > lines;
+
+	if ( payload.size() < 4 )
+		return lines;
+
+	const char* data = payload.constData();
+	const qint64 size = payload.size();
+
+	const auto count = qFromLittleEndian < quint32 >( data );
+	qint64 offset = 4;
+
+	for ( quint32 i = 0; i < count; ++i )
+	{
+		// Type, time and channel name size
+		if ( size - offset < 11 )
+			break;
+
+		LineData line;
+		line.Type = static_cast < ePrintType >( data[ offset ] );
+		line.Time = QDateTime::fromMSecsSinceEpoch( qFromLittleEndian < qint64 >( data + offset + 1 ) );
+
+		const auto channelSize = qFromLittleEndian < quint16 >( data + offset + 9 );
+		offset += 11;
+
+		// Channel name and text size
+		if ( size - offset < channelSize + 4 )
+			break;
+
+		const int channel = LogChannels::Register( QString::fromUtf8( data + offset, channelSize ) );
+		line.Channel = LogChannels::IsValid( channel ) ? channel : LogChannels::DefaultChannel;
+
+		const auto textSize = qFromLittleEndian < quint32 >( data + offset + channelSize );
+		offset += channelSize + 4;
+
+		if ( size - offset < textSize )
+			break;
+
+		line.Text = QString::fromUtf8( data + offset, static_cast < int >( textSize ) );
+		offset += textSize;
+
+		lines.push_back( line );
+	}
+
+	return lines;
+}
+
+quint32 RemoteProtocol::DecodeDropped( const QByteArray& payload ) { return payload.size() < 4 ? 0 : qFromLittleEndian < quint32 >( payload.constData() ); }
+
+void RemoteProtocol::AppendUInt16( QByteArray& out, const quint16 value )
+{
+	char bytes[ 2 ];
+	qToLittleEndian( value, bytes );
+	out.append( bytes, 2 );
+}
+
+void RemoteProtocol::AppendUInt32( QByteArray& out, const quint32 value )
+{
+	char bytes[ 4 ];
+	qToLittleEndian( value, bytes );
+	out.append( bytes, 4 );
+}
+
+void RemoteProtocol::AppendInt64( QByteArray& out, const qint64 value )
+{
+	char bytes[ 8 ];
+	qToLittleEndian( value, bytes );
+	out.append( bytes, 8 );
+}
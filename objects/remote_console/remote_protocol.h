@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+
+#include "utils/const.h"
+#include "objects/line_data/line_data.h"
+#include "objects/log_channels/log_channels.h"
+
+enum class eRemoteMessage : quint8
+{
+	MESSAGE_COMMAND = 1, // Client -> server, UTF-8 command line
+	MESSAGE_SET_FILTER, // Client -> server, UTF-8 LineQuery, empty to receive everything
+	MESSAGE_LINES, // Server -> client, quint32 count then count line records
+	MESSAGE_DROPPED // Server -> client, quint32 number of lines dropped because the client was too slow
+};
+
+// Remote console framing : quint32 payload size | quint8 eRemoteMessage | payload, integers are little endian.
+// A line record is quint8 ePrintType | qint64 msecs since epoch | quint16 size | UTF-8 channel name | quint32 size | UTF-8 text.
+// Channel ids are only valid in one process, the name is sent and mapped to a local id when decoded.
+class RemoteProtocol final
+{
+public:
+	enum class eReadResult
+	{
+		READ_INCOMPLETE,
+		READ_FRAME,
+		READ_INVALID
+	};
+
+	[[nodiscard]] static QByteArray EncodeFrame( eRemoteMessage type, const QByteArray& payload );
+	[[nodiscard]] static QByteArray EncodeLines( const QByteArray& records, quint32 count );
+	[[nodiscard]] static QByteArray EncodeDropped( quint32 count );
+	static void AppendLineRecord( QByteArray& records, const LineData& line );
+
+	// Consumes one frame from the front of buffer when it is complete
+	static eReadResult ReadFrame( QByteArray& buffer, eRemoteMessage& type, QByteArray& payload, quint32 maxPayloadSize = MaxPayloadSize );
+
+	// Registers the channel names it meets, lines of a channel that can not be registered go to the default one
+	[[nodiscard]] static QList < LineData > DecodeLines( const QByteArray& payload );
+	[[nodiscard]] static quint32 DecodeDropped( const QByteArray& payload );
+
+	static constexpr int HeaderSize = 5;
+	static constexpr quint32 MaxPayloadSize = 16 * 1024 * 1024;
+
+private:
+	static void AppendUInt16( QByteArray& out, quint16 value );
+	static void AppendUInt32( QByteArray& out, quint32 value );
+	static void AppendInt64( QByteArray& out, qint64 value );
+};
@@ -0,0 +1,237 @@
+#include "scrollback.h"
+
+#include <algorithm>
+
+#include <QtEndian>
+
+#include "utils/defines.h"
+#include "objects/lz_codec/lz_codec.h"
+
+// Record layout, little endian :
+//   qint64 time in ms since epoch | quint8 ePrintType | quint8 channel | quint32 size | UTF-8 text
+static constexpr int RecordHeaderSize = 8 + 1 + 1 + 4;
+
+void Scrollback::Append( const LineData& line, const quint64 lineId )
+{
+	if ( openLineCount > 0 && lineId != nextLineId )
+		SealBlock();
+
+	if ( openLineCount == 0 )
+		openFirstLineId = lineId;
+
+	const int previousSize = static_cast < int >( openRecords.size() );
+	AppendRecord( openRecords, line );
+
+	const qint64 recordSize = openRecords.size() - previousSize;
+
+	++openLineCount;
+	nextLineId = lineId + 1;
+
+	// Stored as is until the block is sealed
+	++stats.LineCount;
+	stats.RawBytes += recordSize;
+	stats.StoredBytes += recordSize;
+
+	if ( openRecords.size() >= BlockSize )
+		SealBlock();
+
+	DropOldBlocks();
+}
+
+void Scrollback::Clear()
+{
+	blocks.clear();
+	cache.clear();
+
+	openRecords.clear();
+	openLineCount = 0;
+
+	stats = {};
+}
+
+void Scrollback::SetBudget( const qint64 bytes )
+{
+	budget = bytes;
+	DropOldBlocks();
+}
+
+quint64 Scrollback::GetFirstLineId() const
+{
+	if ( !blocks.isEmpty() )
+		return blocks.front().FirstLineId;
+
+	return openLineCount > 0 ? openFirstLineId : nextLineId;
+}
+
+const LineData* Scrollback::FindLine( const quint64 lineId ) const
+{
+	const QList < LineData >* lines;
+	quint64 firstLineId;
+
+	if ( openLineCount > 0 && lineId >= openFirstLineId )
+	{
+		firstLineId = openFirstLineId;
+		lines = &GetBlockLines( openFirstLineId, openLineCount, nullptr );
+	}
+	else
+	{
+		// Last block starting at or before the line
+		const auto it = std::upper_bound( blocks.cbegin(), blocks.cend(), lineId, []( const quint64 id, const Block& block ) { return id < block.FirstLineId; } );
+
+		if ( it == blocks.cbegin() )
+			return nullptr;
+
+		const Block& block = *std::prev( it );
+
+		if ( lineId - block.FirstLineId >= static_cast < quint64 >( block.LineCount ) )
+			return nullptr;
+
+		firstLineId = block.FirstLineId;
+		lines = &GetBlockLines( block.FirstLineId, block.LineCount, &block );
+	}
+
+	const quint64 index = lineId - firstLineId;
+
+	return index < static_cast < quint64 >( lines->size() ) ? &( *lines )[ static_cast < int >( index ) ] : nullptr;
+}
+
+void Scrollback::ForEachLine( const std::function < bool( const LineData&, quint64 ) >& callback ) const
+{
+	for ( const Block& block : blocks )
+	{
+		// Not cached, a full scan does not keep a copy of every block around
+		quint64 lineId = block.FirstLineId;
+
+		for ( const LineData& line : DecompressBlock( block ) )
+		{
+			if ( !callback( line, lineId++ ) )
+				return;
+		}
+	}
+
+	quint64 lineId = openFirstLineId;
+
+	for ( const LineData& line : ParseRecords( openRecords, openLineCount ) )
+	{
+		if ( !callback( line, lineId++ ) )
+			return;
+	}
+}
+
+void Scrollback::SealBlock()
+{
+	if ( openLineCount == 0 )
+		return;
+
+	const int rawSize = static_cast < int >( openRecords.size() );
+
+	QByteArray buffer( LzCodec::GetMaxCompressedSize( rawSize ), Qt::Uninitialized );
+	const int size = LzCodec::Compress( openRecords.constData(), rawSize, buffer.data() );
+
+	// Copied so the block does not keep the worst case capacity
+	blocks.push_back( { openFirstLineId, openLineCount, rawSize, QByteArray( buffer.constData(), size ) } );
+
+	stats.StoredBytes += size - rawSize;
+
+	openRecords.clear();
+	openLineCount = 0;
+}
+
+void Scrollback::DropOldBlocks()
+{
+	if ( stats.StoredBytes <= budget || blocks.isEmpty() )
+		return;
+
+	while ( stats.StoredBytes > budget && !blocks.isEmpty() )
+	{
+		const Block& block = blocks.front();
+
+		stats.LineCount -= block.LineCount;
+		stats.RawBytes -= block.RawSize;
+		stats.StoredBytes -= block.Data.size();
+
+		blocks.pop_front();
+	}
+
+	const quint64 firstLineId = GetFirstLineId();
+	cache.erase( std::remove_if( cache.begin(), cache.end(), [ firstLineId ]( const CachedBlock& cached ) { return cached.FirstLineId < firstLineId; } ), cache.end() );
+}
+
+const QList < LineData >& Scrollback::GetBlockLines( const quint64 firstLineId, const int lineCount, const Block* block ) const
+{
+	for ( int i = 0; i < cache.size(); ++i )
+	{
+		if ( cache[ i ].FirstLineId != firstLineId )
+			continue;
+
+		// The open block got more lines since it was cached
+		if ( cache[ i ].Lines.size() != lineCount )
+		{
+			cache.removeAt( i );
+			break;
+		}
+
+		cache.move( i, 0 );
+		return cache.front().Lines;
+	}
+
+	if ( cache.size() == CacheSize )
+		cache.pop_back();
+
+	cache.push_front( { firstLineId, block ? DecompressBlock( *block ) : ParseRecords( openRecords, openLineCount ) } );
+
+	return cache.front().Lines;
+}
+
+QList < LineData > Scrollback::DecompressBlock( const Block& block )
+{
+	QByteArray records( block.RawSize, Qt::Uninitialized );
+
+	// A corrupted block reads as empty
+	if ( !LzCodec::Decompress( block.Data.constData(), static_cast < int >( block.Data.size() ), records.data(), block.RawSize ) )
+		return {};
+
+	return ParseRecords( records, block.LineCount );
+}
+
+void Scrollback::AppendRecord( QByteArray& records, const LineData& line )
+{
+	const QByteArray text = line.Text.toUtf8();
+
+	char header[ RecordHeaderSize ];
+	qToLittleEndian( line.Time.toMSecsSinceEpoch(), header );
+	header[ 8 ] = static_cast < char >( line.Type );
+	header[ 9 ] = static_cast < char >( line.Channel );
+	qToLittleEndian( static_cast < quint32 >( text.size() ), header + 10 );
+
+	records.append( header, RecordHeaderSize );
+	records.append( text );
+}
+
+QList < LineData > Scrollback::ParseRecords( const QByteArray& records, const int count )
+{
+	QList < LineData > lines;
+	lines.reserve( count );
+
+	const char* data = records.constData();
+	const char* end = data + records.size();
+
+	while ( lines.size() < count && end - data >= RecordHeaderSize )
+	{
+		const auto size = static_cast < int >( qFromLittleEndian < quint32 >( data + 10 ) );
+
+		if ( end - data - RecordHeaderSize < size )
+			break;
+
+		LineData line;
+		line.Time = QDateTime::fromMSecsSinceEpoch( qFromLittleEndian < qint64 >( data ) );
+		line.Type = static_cast < ePrintType >( static_cast < uchar >( data[ 8 ] ) );
+		line.Channel = static_cast < uchar >( data[ 9 ] );
+		line.Text = QString::fromUtf8( data + RecordHeaderSize, size );
+
+		lines.push_back( line );
+		data += RecordHeaderSize + size;
+	}
+
+	return lines;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <functional>
+
+#include <QByteArray>
+#include <QList>
+
+#include "console_widget_global.h"
+#include "utils/const.h"
+
+#include "objects/line_data/line_data.h"
+
+struct ScrollbackStats
+{
+	qint64 LineCount = 0;
+	qint64 RawBytes = 0; // Records ( UTF-8 text and header ) before compression
+	qint64 StoredBytes = 0; // Compressed blocks and the open block
+
+	[[nodiscard]] double GetRatio() const { return StoredBytes > 0 ? static_cast < double >( RawBytes ) / static_cast < double >( StoredBytes ) : 1.0; }
+};
+
+// Cold history of a console : lines pushed out of the hot window of the core.
+// Lines are packed into blocks of BlockSize bytes compressed with LzCodec. FindLine decompresses the block of a line on demand
+// and keeps the last few in a cache, ForEachLine decompresses them one at a time without caching.
+// The oldest blocks are dropped once the stored size goes past the budget, which is 0 until set.
+// Copies share the blocks, a worker scans its own copy while the console keeps appending to the original.
+class CONSOLE_WIDGET_EXPORT Scrollback final
+{
+public:
+	// Line ids must increase, a gap starts a new block
+	void Append( const LineData& line, quint64 lineId );
+	void Clear();
+
+	void SetBudget( qint64 bytes );
+	[[nodiscard]] qint64 GetBudget() const { return budget; }
+
+	[[nodiscard]] bool IsEmpty() const { return stats.LineCount == 0; }
+	[[nodiscard]] ScrollbackStats GetStats() const { return stats; }
+
+	// Id of the oldest line kept, GetEndLineId() when empty
+	[[nodiscard]] quint64 GetFirstLineId() const;
+	[[nodiscard]] quint64 GetEndLineId() const { return nextLineId; }
+
+	// Null when the line is not kept. The pointer is valid until the next call, the cache makes the lookup not thread safe
+	[[nodiscard]] const LineData* FindLine( quint64 lineId ) const;
+
+	// Oldest line first, stops as soon as the callback returns false
+	void ForEachLine( const std::function < bool( const LineData&, quint64 ) >& callback ) const;
+
+	// Memory a line takes as LineData, used to budget the uncompressed lines of a console
+	[[nodiscard]] static qint64 GetLineBytes( const LineData& line ) { return static_cast < qint64 >( sizeof( LineData ) ) + static_cast < qint64 >( line.Text.size() ) * static_cast < qint64 >( sizeof( QChar ) ); }
+
+	static constexpr int BlockSize = 64 * 1024;
+	static constexpr int CacheSize = 4; // Decompressed blocks kept by FindLine
+
+private:
+	struct Block
+	{
+		quint64 FirstLineId;
+		int LineCount;
+		int RawSize;
+		QByteArray Data; // Compressed records
+	};
+
+	QList < Block > blocks;
+
+	// Raw records of the block being filled
+	QByteArray openRecords;
+	quint64 openFirstLineId = 0;
+	int openLineCount = 0;
+
+	quint64 nextLineId = 0;
+	qint64 budget = 0;
+	ScrollbackStats stats;
+
+	struct CachedBlock
+	{
+		quint64 FirstLineId;
+		QList < LineData > Lines;
+	};
+
+	mutable QList < CachedBlock > cache; // Most recently used first
+
+	void SealBlock();
+	void DropOldBlocks();
+
+	// The open block when block is null
+	[[nodiscard]] const QList < LineData >& GetBlockLines( quint64 firstLineId, int lineCount, const Block* block ) const;
+
+	[[nodiscard]] static QList < LineData > DecompressBlock( const Block& block );
+
+	static void AppendRecord( QByteArray& records, const LineData& line );
+	[[nodiscard]] static QList < LineData > ParseRecords( const QByteArray& records, int count );
+};
@@ -0,0 +1,166 @@
+#include "scrollback_test.h"
+
+#include <QTest>
+
+#include "scrollback.h"
+
+static constexpr int LineCount = 5000;
+static constexpr quint64 FirstLineId = 100;
+
+static LineData MakeLine( const int index )
+{
+	// Varied enough to fill several blocks, with non ASCII text to go through UTF-8
+	return { QString( "[%1] line %2 température %3" ).arg( index % 7 ).arg( index ).arg( QString( index % 13, QChar( 0x4E2D ) ) ),
+		static_cast < ePrintType >( index % 5 ),
+		QDateTime::fromMSecsSinceEpoch( 1700000000000 + index * 17 ),
+		index % 3 };
+}
+
+static bool SameLine( const LineData& a, const LineData& b )
+{
+	return a.Text == b.Text && a.Type == b.Type && a.Time == b.Time && a.Channel == b.Channel;
+}
+
+static Scrollback MakeScrollback( const qint64 budget = 1024 * 1024 * 1024 )
+{
+	Scrollback scrollback;
+	scrollback.SetBudget( budget );
+
+	for ( int i = 0; i < LineCount; ++i )
+		scrollback.Append( MakeLine( i ), FirstLineId + i );
+
+	return scrollback;
+}
+
+void ScrollbackTest::AppendKeepsIdsAndOrder()
+{
+	const Scrollback scrollback = MakeScrollback();
+
+	QCOMPARE( scrollback.GetStats().LineCount, qint64( LineCount ) );
+	QCOMPARE( scrollback.GetFirstLineId(), FirstLineId );
+	QCOMPARE( scrollback.GetEndLineId(), FirstLineId + LineCount );
+
+	int index = 0;
+
+	scrollback.ForEachLine( [ &index ]( const LineData& line, const quint64 lineId )
+	{
+		if ( lineId != FirstLineId + index || !SameLine( line, MakeLine( index ) ) )
+			return false;
+
+		++index;
+		return true;
+	} );
+
+	QCOMPARE( index, LineCount );
+}
+
+void ScrollbackTest::FindLine()
+{
+	const Scrollback scrollback = MakeScrollback();
+
+	// Jumps between blocks, more of them than the cache holds
+	for ( int step = 0; step < LineCount; ++step )
+	{
+		const int index = step * 7919 % LineCount;
+		const LineData* line = scrollback.FindLine( FirstLineId + index );
+
+		QVERIFY( line );
+		QVERIFY( SameLine( *line, MakeLine( index ) ) );
+	}
+
+	QVERIFY( !scrollback.FindLine( 0 ) );
+	QVERIFY( !scrollback.FindLine( FirstLineId - 1 ) );
+	QVERIFY( !scrollback.FindLine( FirstLineId + LineCount ) );
+}
+
+void ScrollbackTest::GapStartsNewBlock()
+{
+	Scrollback scrollback;
+	scrollback.SetBudget( 1024 * 1024 );
+
+	for ( int i = 0; i < 10; ++i )
+		scrollback.Append( MakeLine( i ), i );
+
+	for ( int i = 20; i < 30; ++i )
+		scrollback.Append( MakeLine( i ), i );
+
+	QVERIFY( scrollback.FindLine( 9 ) );
+	QVERIFY( !scrollback.FindLine( 15 ) );
+	QVERIFY( SameLine( *scrollback.FindLine( 25 ), MakeLine( 25 ) ) );
+
+	QList < quint64 > lineIds;
+	scrollback.ForEachLine( [ &lineIds ]( const LineData&, const quint64 lineId )
+	{
+		lineIds.push_back( lineId );
+		return true;
+	} );
+
+	QCOMPARE( lineIds.size(), 20 );
+	QCOMPARE( lineIds[ 9 ], quint64( 9 ) );
+	QCOMPARE( lineIds[ 10 ], quint64( 20 ) );
+}
+
+void ScrollbackTest::BudgetDropsOldBlocks()
+{
+	const Scrollback scrollback = MakeScrollback( 3 * Scrollback::BlockSize );
+	const ScrollbackStats stats = scrollback.GetStats();
+
+	QVERIFY( stats.StoredBytes <= 3 * Scrollback::BlockSize );
+	QVERIFY( scrollback.GetFirstLineId() > FirstLineId );
+	QVERIFY( !scrollback.FindLine( FirstLineId ) );
+
+	// What is left is the newest lines, without holes
+	qint64 count = 0;
+	quint64 expectedId = scrollback.GetFirstLineId();
+
+	scrollback.ForEachLine( [ & ]( const LineData& line, const quint64 lineId )
+	{
+		if ( lineId != expectedId++ || !SameLine( line, MakeLine( static_cast < int >( lineId - FirstLineId ) ) ) )
+			return false;
+
+		++count;
+		return true;
+	} );
+
+	QCOMPARE( count, stats.LineCount );
+	QCOMPARE( expectedId, FirstLineId + LineCount );
+}
+
+void ScrollbackTest::Stats()
+{
+	Scrollback scrollback;
+	scrollback.SetBudget( 1024 * 1024 );
+
+	QVERIFY( scrollback.IsEmpty() );
+	QCOMPARE( scrollback.GetStats().GetRatio(), 1.0 );
+
+	// Below a block, stored as is
+	scrollback.Append( { "short", ePrintType::PRINT_INFO, QDateTime::currentDateTime(), 0 }, 0 );
+	QCOMPARE( scrollback.GetStats().StoredBytes, scrollback.GetStats().RawBytes );
+
+	for ( int i = 1; i < 5000; ++i )
+		scrollback.Append( { "[2024-01-02 10:00:00] [INFO]     the same line again", ePrintType::PRINT_INFO, QDateTime::currentDateTime(), 0 }, i );
+
+	const ScrollbackStats stats = scrollback.GetStats();
+
+	QVERIFY( stats.RawBytes > Scrollback::BlockSize );
+	QVERIFY( stats.StoredBytes < stats.RawBytes );
+	QVERIFY( stats.GetRatio() > 5.0 );
+
+	scrollback.Clear();
+	QVERIFY( scrollback.IsEmpty() );
+	QCOMPARE( scrollback.GetStats().StoredBytes, qint64( 0 ) );
+	QVERIFY( !scrollback.FindLine( 10 ) );
+}
+
+void ScrollbackTest::CopyIsIndependent()
+{
+	Scrollback scrollback = MakeScrollback();
+	const Scrollback copy = scrollback;
+
+	scrollback.Clear();
+
+	QVERIFY( scrollback.IsEmpty() );
+	QCOMPARE( copy.GetStats().LineCount, qint64( LineCount ) );
+	QVERIFY( SameLine( *copy.FindLine( FirstLineId + LineCount - 1 ), MakeLine( LineCount - 1 ) ) );
+}
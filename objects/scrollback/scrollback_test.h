@@ -0,0 +1,14 @@
+#pragma once
+
+#include <QObject>
+
+class ScrollbackTest final : public QObject
+{
+	Q_OBJECT private slots:
+	void AppendKeepsIdsAndOrder();
+	void FindLine();
+	void GapStartsNewBlock();
+	void BudgetDropsOldBlocks();
+	void Stats();
+	void CopyIsIndependent();
+};
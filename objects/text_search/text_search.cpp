@@ -0,0 +1,229 @@
+#include "text_search.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <QtAlgorithms>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || defined( _M_AMD64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+# define TEXT_SEARCH_SIMD
+# include <immintrin.h>
+# if defined( _MSC_VER )
+#  include <intrin.h>
+#  define TEXT_SEARCH_TARGET_AVX2
+# else
+#  define TEXT_SEARCH_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+# endif
+#endif
+
+TextSearch::TextSearch( const QString& needle )
+{
+	pattern.reserve( needle.size() );
+
+	for ( const QChar c : needle )
+		pattern.append( QChar( Fold( static_cast < char16_t >( c.unicode() ) ) ) );
+
+	if ( pattern.isEmpty() )
+		return;
+
+	vectorized = GetVariants( static_cast < char16_t >( pattern.front().unicode() ), first ) && GetVariants( static_cast < char16_t >( pattern.back().unicode() ), last );
+}
+
+bool TextSearch::GetVariants( const char16_t folded, char16_t* variants )
+{
+	// ( folded, code unit ) for every code unit that is not its own folding, sorted. Covers forms
+	// like the Kelvin sign, long s or final sigma that uppercasing the folded character does not give back
+	static const std::vector < std::pair < char16_t, char16_t > > foldings = []
+	{
+		std::vector < std::pair < char16_t, char16_t > > table;
+
+		for ( char32_t unit = 0; unit <= 0xFFFF; ++unit )
+		{
+			if ( const char16_t fold = Fold( static_cast < char16_t >( unit ) ); fold != unit )
+				table.emplace_back( fold, static_cast < char16_t >( unit ) );
+		}
+
+		std::sort( table.begin(), table.end() );
+		return table;
+	}();
+
+	auto it = std::lower_bound( foldings.begin(), foldings.end(), std::pair < char16_t, char16_t >( folded, 0 ) );
+
+	int count = 0;
+	variants[ count++ ] = folded;
+
+	for ( ; it != foldings.end() && it->first == folded; ++it )
+	{
+		if ( count == MaxVariants )
+			return false;
+
+		variants[ count++ ] = it->second;
+	}
+
+	for ( ; count < MaxVariants; ++count )
+		variants[ count ] = variants[ count - 1 ];
+
+	return true;
+}
+
+qsizetype TextSearch::IndexIn( const QString& text, const qsizetype from ) const { return IndexIn( reinterpret_cast < const char16_t* >( text.utf16() ), text.size(), from ); }
+
+qsizetype TextSearch::IndexIn( const char16_t* text, const qsizetype size, const qsizetype from ) const
+{
+	if ( pattern.isEmpty() || from < 0 || size - from < pattern.size() )
+		return -1;
+
+#if defined( TEXT_SEARCH_SIMD )
+	static const bool avx2 = HasAvx2();
+
+	if ( !vectorized )
+		return IndexInScalar( text, size, from );
+
+	return avx2 ? IndexInAvx2( text, size, from ) : IndexInSse2( text, size, from );
+#else
+	return IndexInScalar( text, size, from );
+#endif
+}
+
+bool TextSearch::Verify( const char16_t* candidate ) const
+{
+	const auto* folded = reinterpret_cast < const char16_t* >( pattern.utf16() );
+	const qsizetype length = pattern.size();
+
+	for ( qsizetype i = 0; i < length; ++i )
+	{
+		if ( Fold( candidate[ i ] ) != folded[ i ] )
+			return false;
+	}
+
+	return true;
+}
+
+qsizetype TextSearch::IndexInScalar( const char16_t* text, const qsizetype size, const qsizetype from ) const
+{
+	const qsizetype end = size - pattern.size();
+	const auto firstFolded = static_cast < char16_t >( pattern.front().unicode() );
+
+	for ( qsizetype i = from; i <= end; ++i )
+	{
+		if ( Fold( text[ i ] ) == firstFolded && Verify( text + i ) )
+			return i;
+	}
+
+	return -1;
+}
+
+#if defined( TEXT_SEARCH_SIMD )
+
+// Both kernels compare the first and last needle characters of every position of a block at once
+// and only verify the positions where both match, the scalar loop handles the tail.
+qsizetype TextSearch::IndexInSse2( const char16_t* text, const qsizetype size, const qsizetype from ) const
+{
+	constexpr qsizetype Lanes = 8;
+
+	const qsizetype lastOffset = pattern.size() - 1;
+
+	const __m128i first0 = _mm_set1_epi16( static_cast < short >( first[ 0 ] ) );
+	const __m128i first1 = _mm_set1_epi16( static_cast < short >( first[ 1 ] ) );
+	const __m128i first2 = _mm_set1_epi16( static_cast < short >( first[ 2 ] ) );
+	const __m128i last0 = _mm_set1_epi16( static_cast < short >( last[ 0 ] ) );
+	const __m128i last1 = _mm_set1_epi16( static_cast < short >( last[ 1 ] ) );
+	const __m128i last2 = _mm_set1_epi16( static_cast < short >( last[ 2 ] ) );
+
+	qsizetype i = from;
+
+	for ( ; i + lastOffset + Lanes <= size; i += Lanes )
+	{
+		const __m128i blockFirst = _mm_loadu_si128( reinterpret_cast < const __m128i* >( text + i ) );
+		const __m128i blockLast = _mm_loadu_si128( reinterpret_cast < const __m128i* >( text + i + lastOffset ) );
+
+		const __m128i eqFirst = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi16( blockFirst, first0 ), _mm_cmpeq_epi16( blockFirst, first1 ) ), _mm_cmpeq_epi16( blockFirst, first2 ) );
+		const __m128i eqLast = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi16( blockLast, last0 ), _mm_cmpeq_epi16( blockLast, last1 ) ), _mm_cmpeq_epi16( blockLast, last2 ) );
+
+		// 2 mask bits per 16 bits lane
+		auto mask = static_cast < quint32 >( _mm_movemask_epi8( _mm_and_si128( eqFirst, eqLast ) ) );
+
+		while ( mask )
+		{
+			const int bit = static_cast < int >( qCountTrailingZeroBits( mask ) );
+
+			if ( Verify( text + i + bit / 2 ) )
+				return i + bit / 2;
+
+			mask &= ~( 3u << bit );
+		}
+	}
+
+	return IndexInScalar( text, size, i );
+}
+
+TEXT_SEARCH_TARGET_AVX2 qsizetype TextSearch::IndexInAvx2( const char16_t* text, const qsizetype size, const qsizetype from ) const
+{
+	constexpr qsizetype Lanes = 16;
+
+	const qsizetype lastOffset = pattern.size() - 1;
+
+	const __m256i first0 = _mm256_set1_epi16( static_cast < short >( first[ 0 ] ) );
+	const __m256i first1 = _mm256_set1_epi16( static_cast < short >( first[ 1 ] ) );
+	const __m256i first2 = _mm256_set1_epi16( static_cast < short >( first[ 2 ] ) );
+	const __m256i last0 = _mm256_set1_epi16( static_cast < short >( last[ 0 ] ) );
+	const __m256i last1 = _mm256_set1_epi16( static_cast < short >( last[ 1 ] ) );
+	const __m256i last2 = _mm256_set1_epi16( static_cast < short >( last[ 2 ] ) );
+
+	qsizetype i = from;
+
+	for ( ; i + lastOffset + Lanes <= size; i += Lanes )
+	{
+		const __m256i blockFirst = _mm256_loadu_si256( reinterpret_cast < const __m256i* >( text + i ) );
+		const __m256i blockLast = _mm256_loadu_si256( reinterpret_cast < const __m256i* >( text + i + lastOffset ) );
+
+		const __m256i eqFirst = _mm256_or_si256( _mm256_or_si256( _mm256_cmpeq_epi16( blockFirst, first0 ), _mm256_cmpeq_epi16( blockFirst, first1 ) ), _mm256_cmpeq_epi16( blockFirst, first2 ) );
+		const __m256i eqLast = _mm256_or_si256( _mm256_or_si256( _mm256_cmpeq_epi16( blockLast, last0 ), _mm256_cmpeq_epi16( blockLast, last1 ) ), _mm256_cmpeq_epi16( blockLast, last2 ) );
+
+		auto mask = static_cast < quint32 >( _mm256_movemask_epi8( _mm256_and_si256( eqFirst, eqLast ) ) );
+
+		while ( mask )
+		{
+			const int bit = static_cast < int >( qCountTrailingZeroBits( mask ) );
+
+			if ( Verify( text + i + bit / 2 ) )
+				return i + bit / 2;
+
+			mask &= ~( 3u << bit );
+		}
+	}
+
+	return IndexInSse2( text, size, i );
+}
+
+bool TextSearch::HasAvx2()
+{
+# if defined( _MSC_VER )
+	int info[ 4 ] = {};
+
+	__cpuid( info, 0 );
+	if ( info[ 0 ] < 7 )
+		return false;
+
+	// OSXSAVE and AVX, then check the OS saves the YMM registers
+	__cpuid( info, 1 );
+	if ( ( info[ 2 ] & ( 1 << 27 ) ) == 0 || ( info[ 2 ] & ( 1 << 28 ) ) == 0 || ( _xgetbv( 0 ) & 0x6 ) != 0x6 )
+		return false;
+
+	__cpuidex( info, 7, 0 );
+	return ( info[ 1 ] & ( 1 << 5 ) ) != 0;
+# else
+	return __builtin_cpu_supports( "avx2" );
+# endif
+}
+
+#else
+
+qsizetype TextSearch::IndexInSse2( const char16_t* text, const qsizetype size, const qsizetype from ) const { return IndexInScalar( text, size, from ); }
+
+qsizetype TextSearch::IndexInAvx2( const char16_t* text, const qsizetype size, const qsizetype from ) const { return IndexInScalar( text, size, from ); }
+
+bool TextSearch::HasAvx2() { return false; }
+
+#endif
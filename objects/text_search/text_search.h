@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QString>
+
+// Case-insensitive UTF-16 substring search.
+// Candidates are located with SSE2 / AVX2 on x86 ( picked at runtime ), then verified on the case folded text.
+class TextSearch
+{
+public:
+	TextSearch() = default;
+	explicit TextSearch( const QString& needle );
+
+	[[nodiscard]] bool IsEmpty() const { return pattern.isEmpty(); }
+	[[nodiscard]] qsizetype GetLength() const { return pattern.size(); }
+	[[nodiscard]] QString GetPattern() const { return pattern; }
+
+	// Returns the position of the first match at or after from, -1 when not found
+	[[nodiscard]] qsizetype IndexIn( const QString& text, qsizetype from = 0 ) const;
+	[[nodiscard]] qsizetype IndexIn( const char16_t* text, qsizetype size, qsizetype from = 0 ) const;
+
+	[[nodiscard]] bool IsFoundIn( const QString& text ) const { return IndexIn( text ) >= 0; }
+
+	[[nodiscard]] static char16_t Fold( const char16_t c )
+	{
+		if ( c < 0x80 )
+			return c >= u'A' && c <= u'Z' ? static_cast < char16_t >( c | 0x20 ) : c;
+
+		return static_cast < char16_t >( QChar( c ).toCaseFolded().unicode() );
+	}
+
+private:
+	friend class TextSearchTest;
+
+	static constexpr int MaxVariants = 3;
+
+	QString pattern; // Case folded needle
+
+	// Every code unit folding to the first and last needle characters, padded by repeating the last one.
+	// Candidates are found by comparing with these, more variants than MaxVariants fall back to the scalar search.
+	char16_t first[ MaxVariants ] = {};
+	char16_t last[ MaxVariants ] = {};
+	bool vectorized = false;
+
+	[[nodiscard]] bool Verify( const char16_t* candidate ) const;
+
+	[[nodiscard]] qsizetype IndexInScalar( const char16_t* text, qsizetype size, qsizetype from ) const;
+	[[nodiscard]] qsizetype IndexInSse2( const char16_t* text, qsizetype size, qsizetype from ) const;
+	[[nodiscard]] qsizetype IndexInAvx2( const char16_t* text, qsizetype size, qsizetype from ) const;
+
+	[[nodiscard]] static bool HasAvx2();
+	static bool GetVariants( char16_t folded, char16_t* variants );
+};
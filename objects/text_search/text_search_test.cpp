@@ -0,0 +1,110 @@
+#include "text_search_test.h"
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include "text_search.h"
+
+int TextSearchTest::ComparePaths( const QString& needle, const QString& text )
+{
+	const TextSearch search( needle );
+	const auto* data = reinterpret_cast < const char16_t* >( text.utf16() );
+	const qsizetype size = text.size();
+
+	// The kernels rely on the variants, needles with more of them only use the scalar search
+	const bool vectorized = search.vectorized;
+	const bool avx2 = vectorized && TextSearch::HasAvx2();
+
+	int count = 0;
+
+	for ( qsizetype from = 0; from <= size; ++from )
+	{
+		const qsizetype expected = search.IndexInScalar( data, size, from );
+
+		if ( search.IndexIn( text, from ) != expected )
+			return -1;
+
+		if ( vectorized && search.IndexInSse2( data, size, from ) != expected )
+			return -1;
+
+		if ( avx2 && search.IndexInAvx2( data, size, from ) != expected )
+			return -1;
+
+		if ( expected == from )
+			++count;
+	}
+
+	return count;
+}
+
+void TextSearchTest::CaseFoldingVariants()
+{
+	const QString kelvin = QString( "temperature in %1elvin, KELVIN or kelvin, %1 alone" ).arg( QChar( 0x212A ) );
+	QCOMPARE( ComparePaths( "kelvin", kelvin ), 3 );
+	QCOMPARE( ComparePaths( QString( QChar( 0x212A ) ), kelvin ), 4 );
+
+	// Long s folds to s, final sigma to sigma
+	const QString longS = QString( "mis%1 MISS miss" ).arg( QChar( 0x017F ) );
+	QCOMPARE( ComparePaths( "miss", longS ), 3 );
+	QCOMPARE( ComparePaths( QString( QChar( 0x017F ) ), longS ), 6 );
+
+	const QString greek = QString::fromUtf8( "σοφός ΣΟΦΌΣ σοφόσ" );
+	QCOMPARE( ComparePaths( QString::fromUtf8( "ΣΟΦΌΣ" ), greek ), 3 );
+	QCOMPARE( ComparePaths( QString::fromUtf8( "ς" ), greek ), 6 );
+}
+
+void TextSearchTest::NeedleAtTail()
+{
+	// Every length around the SSE2 and AVX2 block sizes, the match being the last characters
+	for ( int size = 0; size < 80; ++size )
+	{
+		const QString text = QString( size, 'x' ) + "NeEdLe";
+
+		QCOMPARE( ComparePaths( "needle", text ), 1 );
+		QCOMPARE( TextSearch( "needle" ).IndexIn( text ), qsizetype( size ) );
+
+		// One character short of a match
+		QCOMPARE( ComparePaths( "needle", text.chopped( 1 ) ), 0 );
+	}
+}
+
+void TextSearchTest::SingleCharacter()
+{
+	const QString text = QString( "Every line of the log, Even the long ones, is searched. " ).repeated( 20 );
+
+	QCOMPARE( ComparePaths( "e", text ), 10 * 20 );
+	QCOMPARE( ComparePaths( ".", text ), 20 );
+	QCOMPARE( ComparePaths( "z", text ), 0 );
+}
+
+void TextSearchTest::NonAscii()
+{
+	const QString text = QString::fromUtf8( "Élève ÉLÈVE élève 中文日志 中文 \xF0\x9F\x98\x80 smile \xF0\x9F\x98\x80" ).repeated( 3 );
+
+	QCOMPARE( ComparePaths( QString::fromUtf8( "élève" ), text ), 9 );
+	QCOMPARE( ComparePaths( QString::fromUtf8( "中文" ), text ), 6 );
+
+	// Surrogate pairs are matched as a whole
+	QCOMPARE( ComparePaths( QString::fromUtf8( "\xF0\x9F\x98\x80" ), text ), 6 );
+	QCOMPARE( ComparePaths( QString::fromUtf8( "\xF0\x9F\x98\x80 s" ), text ), 3 );
+}
+
+void TextSearchTest::RandomText()
+{
+	// A small alphabet of case variants gives many candidates that fail verification
+	const QString alphabet = QString( "aAkK%1sS%2 e%3" ).arg( QChar( 0x212A ) ).arg( QChar( 0x017F ) ).arg( QChar( 0x00C9 ) );
+	QRandomGenerator generator( 1234 );
+
+	for ( int round = 0; round < 50; ++round )
+	{
+		QString text;
+
+		for ( int i = 0, size = generator.bounded( 1, 200 ); i < size; ++i )
+			text.append( alphabet[ generator.bounded( static_cast < int >( alphabet.size() ) ) ] );
+
+		const int length = generator.bounded( 1, 5 );
+		const QString needle = text.mid( generator.bounded( static_cast < int >( text.size() ) ), length );
+
+		QVERIFY( ComparePaths( needle, text ) >= 1 );
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <QObject>
+
+class TextSearchTest final : public QObject
+{
+	Q_OBJECT private slots:
+	void CaseFoldingVariants();
+	void NeedleAtTail();
+	void SingleCharacter();
+	void NonAscii();
+	void RandomText();
+
+private:
+	// Every path finds the same positions as the scalar search from every start, returns the number of matches
+	static int ComparePaths( const QString& needle, const QString& text );
+};
@@ -0,0 +1,45 @@
+// Unit tests of the console objects.
+// Usage: console_tests [QTest options]
+// Runs every test class in turn, exits with the number of classes that had a failure.
+
+#include <QApplication>
+#include <QTest>
+
+#include "objects/command_history/command_history_test.h"
+#include "objects/con_var_batch/con_var_batch_test.h"
+#include "objects/con_var_store/con_var_store_test.h"
+#include "objects/file_tail/file_tail_test.h"
+#include "objects/line_filter/line_filter_test.h"
+#include "objects/line_finder/line_finder_test.h"
+#include "objects/line_query/line_query_test.h"
+#include "objects/line_viewer/line_viewer_test.h"
+#include "objects/lz_codec/lz_codec_test.h"
+#include "objects/scrollback/scrollback_test.h"
+#include "objects/text_search/text_search_test.h"
+
+template < typename T >
+static int RunTest( int argc, char* argv[] )
+{
+	T test;
+	return QTest::qExec( &test, argc, argv ) != 0 ? 1 : 0;
+}
+
+int main( int argc, char* argv[] )
+{
+	QApplication app( argc, argv );
+
+	int failed = 0;
+	failed += RunTest < CommandHistoryTest >( argc, argv );
+	failed += RunTest < ConVarBatchTest >( argc, argv );
+	failed += RunTest < ConVarStoreTest >( argc, argv );
+	failed += RunTest < FileTailTest >( argc, argv );
+	failed += RunTest < LineFilterTest >( argc, argv );
+	failed += RunTest < LineFinderTest >( argc, argv );
+	failed += RunTest < LineQueryTest >( argc, argv );
+	failed += RunTest < LineViewerTest >( argc, argv );
+	failed += RunTest < LzCodecTest >( argc, argv );
+	failed += RunTest < ScrollbackTest >( argc, argv );
+	failed += RunTest < TextSearchTest >( argc, argv );
+
+	return failed;
+}
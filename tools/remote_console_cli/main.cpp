@@ -0,0 +1,123 @@
+// Minimal client for RemoteConsoleServer.
+// Usage: remote_console_cli <server_name> [--filter <query>]
+// Lines typed on stdin are sent as commands, console lines are printed on stdout.
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <QCoreApplication>
+#include <QLocalSocket>
+
+#include "objects/remote_console/remote_protocol.h"
+
+int main( int argc, char* argv[] )
+{
+	QCoreApplication app( argc, argv );
+
+	const QStringList args = QCoreApplication::arguments();
+
+	if ( args.size() < 2 )
+	{
+		std::fprintf( stderr, "Usage: %s <server_name> [--filter <query>]\n", argv[ 0 ] );
+		return 1;
+	}
+
+	QString filter;
+	if ( const int filterIndex = static_cast < int >( args.indexOf( "--filter" ) ); filterIndex != -1 && filterIndex + 1 < args.size() )
+		filter = args[ filterIndex + 1 ];
+
+	QLocalSocket socket;
+	QByteArray incoming;
+
+	QObject::connect( &socket, &QLocalSocket::readyRead, [ &socket, &incoming ]
+	{
+		incoming.append( socket.readAll() );
+
+		eRemoteMessage type;
+		QByteArray payload;
+
+		while ( RemoteProtocol::ReadFrame( incoming, type, payload ) == RemoteProtocol::eReadResult::READ_FRAME )
+		{
+			if ( type == eRemoteMessage::MESSAGE_LINES )
+			{
+				for ( const LineData& line : RemoteProtocol::DecodeLines( payload ) )
+					std::fprintf( stdout, "%s\n", line.Text.toLocal8Bit().constData() );
+			}
+			else if ( type == eRemoteMessage::MESSAGE_DROPPED )
+			{
+				std::fprintf( stdout, "-- %u lines dropped --\n", RemoteProtocol::DecodeDropped( payload ) );
+			}
+		}
+
+		std::fflush( stdout );
+	} );
+
+	QObject::connect( &socket, &QLocalSocket::disconnected, &app, &QCoreApplication::quit );
+
+	socket.connectToServer( args[ 1 ] );
+
+	if ( !socket.waitForConnected( 3000 ) )
+	{
+		std::fprintf( stderr, "Could not connect to %s: %s\n", qPrintable( args[ 1 ] ), qPrintable( socket.errorString() ) );
+		return 1;
+	}
+
+	if ( !filter.isEmpty() )
+		socket.write( RemoteProtocol::EncodeFrame( eRemoteMessage::MESSAGE_SET_FILTER, filter.toUtf8() ) );
+
+	// Blocking stdin reads stay off the event loop, commands are handed over to it.
+	// The reader can not be interrupted and outlives main, it only reaches the socket while main is running.
+	struct InputTarget
+	{
+		std::mutex Mutex;
+		QLocalSocket* Socket = nullptr;
+	};
+
+	const auto target = std::make_shared < InputTarget >();
+	target->Socket = &socket;
+
+	std::thread input( [ target ]
+	{
+		std::string line;
+
+		while ( std::getline( std::cin, line ) )
+		{
+			const QByteArray frame = RemoteProtocol::EncodeFrame( eRemoteMessage::MESSAGE_COMMAND, QByteArray::fromStdString( line ) );
+
+			std::lock_guard lock( target->Mutex );
+
+			if ( !target->Socket )
+				return;
+
+			QLocalSocket* socket = target->Socket;
+			QMetaObject::invokeMethod( socket, [ socket, frame ] { socket->write( frame ); }, Qt::QueuedConnection );
+		}
+
+		std::lock_guard lock( target->Mutex );
+
+		if ( !target->Socket )
+			return;
+
+		// End of input, let the last commands go out before leaving
+		QLocalSocket* socket = target->Socket;
+		QMetaObject::invokeMethod( socket, [ socket ]
+		{
+			socket->flush();
+			socket->waitForBytesWritten( 1000 );
+			QCoreApplication::quit();
+		}, Qt::QueuedConnection );
+	} );
+
+	input.detach();
+
+	const int result = QCoreApplication::exec();
+
+	std::lock_guard lock( target->Mutex );
+	target->Socket = nullptr;
+
+	return result;
+}
@@ -0,0 +1,105 @@
+// Loopback check of the remote console.
+// Usage: remote_console_loopback
+// Starts a RemoteConsoleServer on a console of this process, connects a client to it, sends a command
+// and waits for the line it prints to come back. Exits with 0 when the round trip succeeded.
+// The client only asks for the loopback channel : the printed line is answered on that channel,
+// and the line of the default channel must not come through.
+
+#include <cstdio>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QLocalSocket>
+#include <QTimer>
+
+#include "objects/con_var/con_var.h"
+#include "objects/remote_console/remote_console_server.h"
+#include "objects/remote_console/remote_protocol.h"
+
+static constexpr int LoopbackTimeout = 5000; // ms
+
+int main( int argc, char* argv[] )
+{
+	QCoreApplication app( argc, argv );
+
+	ConVarManager::ConVarInit();
+
+	ConsoleCore core;
+	RemoteConsoleServer server( &core );
+
+	const QString serverName = QString( "console_widget_loopback_%1" ).arg( QCoreApplication::applicationPid() );
+
+	if ( !server.Listen( serverName ) )
+	{
+		std::fprintf( stderr, "Could not listen on %s\n", qPrintable( serverName ) );
+		return 1;
+	}
+
+	// Unique so that an older line can not be mistaken for the reply
+	const QString marker = QString( "loopback %1" ).arg( QDateTime::currentMSecsSinceEpoch() );
+	const int channel = LogChannels::Register( "loopback" );
+
+	// The command ran, so the filter sent before it is set. Answered once the printing is over
+	QObject::connect( &core, &ConsoleCore::LineAdded, &core, [ &core, &marker, channel ]( const LineData& line )
+	{
+		if ( line.Channel == LogChannels::DefaultChannel && line.Text.endsWith( marker ) )
+			QTimer::singleShot( 0, &core, [ &core, &marker, channel ] { core.Print( channel ) << marker; } );
+	} );
+
+	QLocalSocket socket;
+	QByteArray incoming;
+	bool received = false;
+	bool filtered = true;
+
+	QObject::connect( &socket, &QLocalSocket::connected, [ &socket, &marker ]
+	{
+		socket.write( RemoteProtocol::EncodeFrame( eRemoteMessage::MESSAGE_SET_FILTER, QByteArray( "channel:loopback" ) ) );
+		socket.write( RemoteProtocol::EncodeFrame( eRemoteMessage::MESSAGE_COMMAND, QString( "print %1" ).arg( marker ).toUtf8() ) );
+	} );
+
+	QObject::connect( &socket, &QLocalSocket::readyRead, [ &socket, &incoming, &marker, channel, &received, &filtered ]
+	{
+		incoming.append( socket.readAll() );
+
+		eRemoteMessage type;
+		QByteArray payload;
+
+		while ( RemoteProtocol::ReadFrame( incoming, type, payload ) == RemoteProtocol::eReadResult::READ_FRAME )
+		{
+			if ( type != eRemoteMessage::MESSAGE_LINES )
+				continue;
+
+			for ( const LineData& line : RemoteProtocol::DecodeLines( payload ) )
+			{
+				if ( !line.Text.endsWith( marker ) )
+					continue;
+
+				if ( line.Channel != channel )
+				{
+					filtered = false;
+					continue;
+				}
+
+				received = true;
+				QCoreApplication::quit();
+			}
+		}
+	} );
+
+	QTimer::singleShot( LoopbackTimeout, &app, &QCoreApplication::quit );
+
+	socket.connectToServer( serverName );
+	QCoreApplication::exec();
+
+	socket.abort();
+	server.Close();
+
+	if ( !filtered )
+	{
+		std::fprintf( stderr, "Loopback failed, a line outside of the channel filter came back\n" );
+		return 1;
+	}
+
+	std::fprintf( received ? stdout : stderr, received ? "Loopback succeeded\n" : "Loopback failed, the printed line did not come back on its channel\n" );
+	return received ? 0 : 1;
+}
@@ -12,6 +12,7 @@ enum class ePrintType : int
 };
 
 class ConVarBase;
-class ConsoleWidget;
+class ConsoleCore;
 
-using ConVarCallback = std::function < bool( ConVarBase*, const QStringList&, ConsoleWidget* ) >;
+using ConVarCallbackFunction = bool( * )( ConVarBase*, const QStringList&, ConsoleCore* );
+using ConVarCallback = std::function < bool( ConVarBase*, const QStringList&, ConsoleCore* ) >;
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <QWidget>
+#include <QtGlobal>
 
 #if QT_VERSION_MAJOR == 6
 # define QT_6